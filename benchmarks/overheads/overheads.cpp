@@ -0,0 +1,462 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/iostream.hpp>
+#include <hpx/modules/program_options.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/timing.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/coforall_locales.hpp>
+#include <chapel/config.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/forall.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/range.hpp>
+#include <chapel/writeln.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "overheads.hpp"
+
+// Overheads of the task and data parallel constructs used by the examples
+//
+// The loops of hello3-datapar (forall), hello4-datapar-dist (distributed
+// forall), hello5-taskpar (coforall), and hello6-taskpar-dist (coforall
+// over all locales) are executed for all combinations of the given
+// numMessages, numTasks, tasksPerLocale, and task counts, using the same
+// loop bodies as the examples. The results are written as JSON:
+//
+//  - time_s:                    time of the loop
+//  - serial_time_s:             time of executing the loop bodies serially
+//                               on the calling locale
+//  - processing_units:          number of processing units (on all locales)
+//                               the loop can use
+//  - per_iteration_ns:          time per iteration of a forall-loop
+//  - per_iteration_overhead_ns: processing unit time per iteration spent in
+//                               addition to executing the loop bodies
+//                               serially
+//  - per_task_ns:               time per task of a coforall-loop
+//  - spawn_cost_ns:             processing unit time per task spent in
+//                               addition to executing the loop bodies
+//                               serially
+//  - efficiency:                serial_time_s / (time_s * processing_units)
+//
+// All four variants report all of these (per iteration for the forall-loops,
+// per task for the coforall-loops). All times are the median of
+// `repetitions` runs, all sweep values have to be positive. Use
+// --suppressOutput=true to measure the constructs instead of the console
+// I/O. The number of worker threads is fixed for each run (--hpx:threads),
+// the target run_overheads runs the benchmark for several of them.
+
+namespace overheads {
+
+    std::vector<std::int64_t> numMessages = {100, 10000, 1000000};
+    std::vector<std::int64_t> numTasks = {1, 16, 256, 4096};
+    std::vector<std::int64_t> tasksPerLocale = {1, 4, 16};
+    std::vector<std::int64_t> tasks;
+    int repetitions = 10;
+    std::string benchmarkOutput = "-";
+
+    // Reject non-positive values of the option `name`, which would make the
+    // metrics meaningless
+    auto positive(char const* name)
+    {
+        return [name](std::vector<std::int64_t> const& values) {
+            for (std::int64_t value : values)
+            {
+                if (value <= 0)
+                {
+                    throw hpx::program_options::validation_error(
+                        hpx::program_options::validation_error::
+                            invalid_option_value,
+                        name, std::to_string(value));
+                }
+            }
+        };
+    }
+
+    hpx::program_options::options_description get_config_variables()
+    {
+        hpx::program_options::options_description options(
+            "Benchmark options");
+
+        // clang-format off
+        options.add_options()
+            ("numMessages",
+                hpx::program_options::value<std::vector<std::int64_t>>(
+                    &numMessages)->multitoken()
+                    ->notifier(positive("numMessages")),
+                "numbers of iterations of the forall-loops "
+                "(default: 100 10000 1000000)")
+            ("numTasks",
+                hpx::program_options::value<std::vector<std::int64_t>>(
+                    &numTasks)->multitoken()
+                    ->notifier(positive("numTasks")),
+                "numbers of tasks created by the coforall-loop "
+                "(default: 1 16 256 4096)")
+            ("tasksPerLocale",
+                hpx::program_options::value<std::vector<std::int64_t>>(
+                    &tasksPerLocale)->multitoken()
+                    ->notifier(positive("tasksPerLocale")),
+                "numbers of tasks created on each locale "
+                "(default: 1 4 16)")
+            ("tasks",
+                hpx::program_options::value<std::vector<std::int64_t>>(
+                    &tasks)->multitoken()
+                    ->notifier(positive("tasks")),
+                "numbers of tasks used by the local forall-loop "
+                "(default: 1 2 4 ... here.maxTaskPar)")
+            ("repetitions",
+                hpx::program_options::value<int>(&repetitions)
+                    ->notifier([](int value) {
+                        positive("repetitions")({value});
+                    }),
+                "number of measured runs per configuration (default: 10)")
+            ("benchmarkOutput",
+                hpx::program_options::value<std::string>(&benchmarkOutput),
+                "file to write the results to, '-' for the console "
+                "(default: -)")
+        ;
+        // clang-format on
+
+        return options;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The loop bodies of the examples
+    struct forall_1
+    {
+        void operator()(std::int64_t msg) const
+        {
+            chapel::writeln("Hello, world! (from iteration ", msg, " of ",
+                numMessages, ")");
+        }
+
+        std::int64_t numMessages = 0;
+    };
+
+    struct forall_dist
+    {
+        void operator()(std::int64_t msg) const
+        {
+            chapel::writeln("Hello, world! (from iteration ", msg, " of ",
+                numMessages, " owned by locale ", chapel::here().id + 1, " of ",
+                chapel::numLocales(), ")");
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & numMessages;
+            // clang-format on
+        }
+
+        std::int64_t numMessages = 0;
+    };
+
+    struct coforall_1
+    {
+        void operator()(std::int64_t tid) const
+        {
+            chapel::writeln(
+                "Hello, world! (from task ", tid + 1, " of ", numTasks, ")");
+        }
+
+        std::int64_t numTasks = 0;
+    };
+
+    struct coforall_2
+    {
+        void operator()(std::int64_t tid) const
+        {
+            chapel::writeln("Hello, world! (from task ", tid + 1, " of ",
+                tasksPerLocale, " on locale ", chapel::here().id + 1, " of ",
+                chapel::numLocales(), ")");
+        }
+
+        std::int64_t tasksPerLocale = 0;
+    };
+
+    struct coforall_dist
+    {
+        void operator()(chapel::locale const&) const
+        {
+            chapel::coforall(chapel::counted(0, tasksPerLocale),
+                coforall_2{tasksPerLocale});
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & tasksPerLocale;
+            // clang-format on
+        }
+
+        std::int64_t tasksPerLocale = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    struct result
+    {
+        std::string benchmark;
+        std::vector<std::pair<std::string, std::int64_t>> params;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    // Execute `f()` once to warm up and then `repetitions` times, return the
+    // median of the measured times (in seconds). Buffered messages are
+    // written as part of each run.
+    template <typename F>
+    double measure(F&& f)
+    {
+        f();
+        chapel::flush_writeln();
+
+        std::vector<double> times;
+        for (int i = 0; i < repetitions; ++i)
+        {
+            hpx::chrono::high_resolution_timer t;
+            f();
+            chapel::flush_writeln();
+            times.push_back(t.elapsed());
+        }
+
+        std::sort(times.begin(), times.end());
+        return times[times.size() / 2];
+    }
+
+    // The metrics reported for every variant, `count` is the number of
+    // iterations (or tasks) of the loop
+    std::vector<std::pair<std::string, double>> metrics(double t,
+        double serial, std::int64_t units, std::int64_t count,
+        char const* per_item, char const* overhead)
+    {
+        auto const pus = static_cast<double>(units);
+        auto const n = static_cast<double>(count);
+
+        return {{"time_s", t}, {"serial_time_s", serial},
+            {"processing_units", pus}, {per_item, t * 1e9 / n},
+            {overhead, (t * pus - serial) * 1e9 / n},
+            {"efficiency", serial / (t * pus)}};
+    }
+
+    std::vector<std::pair<std::string, double>> forall_metrics(double t,
+        double serial, std::int64_t units, std::int64_t iterations)
+    {
+        return metrics(t, serial, units, iterations, "per_iteration_ns",
+            "per_iteration_overhead_ns");
+    }
+
+    std::vector<std::pair<std::string, double>> coforall_metrics(
+        double t, double serial, std::int64_t units, std::int64_t count)
+    {
+        return metrics(
+            t, serial, units, count, "per_task_ns", "spawn_cost_ns");
+    }
+
+    std::int64_t max_task_par()
+    {
+        return static_cast<std::int64_t>(chapel::here().maxTaskPar);
+    }
+
+    // The numbers of tasks to execute the local forall-loops with
+    std::vector<std::int64_t> task_counts()
+    {
+        std::int64_t const maxTaskPar = max_task_par();
+
+#if defined(CHAPEL_PARAM_dataParTasksPerLocale)
+        // the number of tasks is fixed at compile time
+        return {chapel::dataParTasksPerLocale != 0 ?
+                static_cast<std::int64_t>(chapel::dataParTasksPerLocale) :
+                maxTaskPar};
+#else
+        if (!tasks.empty())
+            return tasks;
+
+        std::vector<std::int64_t> counts;
+        for (std::int64_t n = 1; n < maxTaskPar; n *= 2)
+        {
+            counts.push_back(n);
+        }
+        counts.push_back(maxTaskPar);
+        return counts;
+#endif
+    }
+
+    // hello3-datapar
+    void benchmark_forall(std::vector<result>& results)
+    {
+#if !defined(CHAPEL_PARAM_dataParTasksPerLocale)
+        std::uint32_t const saved = chapel::dataParTasksPerLocale;
+#endif
+
+        for (std::int64_t n : numMessages)
+        {
+            forall_1 const body{n};
+            double const serial = measure([&] {
+                for (std::int64_t i = 1; i <= n; ++i)
+                {
+                    body(i);
+                }
+            });
+
+            for (std::int64_t p : task_counts())
+            {
+#if !defined(CHAPEL_PARAM_dataParTasksPerLocale)
+                chapel::dataParTasksPerLocale = static_cast<std::uint32_t>(p);
+#endif
+                double const t = measure(
+                    [&] { chapel::forall(chapel::range(1, n), body); });
+
+                results.push_back({"forall", {{"numMessages", n}, {"tasks", p}},
+                    forall_metrics(t, serial, p, n)});
+            }
+        }
+
+#if !defined(CHAPEL_PARAM_dataParTasksPerLocale)
+        chapel::dataParTasksPerLocale = saved;
+#endif
+    }
+
+    // hello4-datapar-dist
+    void benchmark_forall_dist(std::vector<result>& results)
+    {
+        std::int64_t const units = chapel::numLocales() * max_task_par();
+
+        for (std::int64_t n : numMessages)
+        {
+            chapel::Cyclic const MessageSpace(chapel::range(1, n), 1);
+
+            forall_dist const body{n};
+            double const serial = measure([&] {
+                for (std::int64_t i = 1; i <= n; ++i)
+                {
+                    body(i);
+                }
+            });
+
+            double const t =
+                measure([&] { chapel::forall(MessageSpace, body); });
+
+            results.push_back({"forall_dist", {{"numMessages", n}},
+                forall_metrics(t, serial, units, n)});
+        }
+    }
+
+    // hello5-taskpar
+    void benchmark_coforall(std::vector<result>& results)
+    {
+        for (std::int64_t n : numTasks)
+        {
+            coforall_1 const body{n};
+            double const serial = measure([&] {
+                for (std::int64_t i = 0; i != n; ++i)
+                {
+                    body(i);
+                }
+            });
+
+            double const t =
+                measure([&] { chapel::coforall(chapel::counted(0, n), body); });
+
+            results.push_back({"coforall", {{"numTasks", n}},
+                coforall_metrics(t, serial, (std::min)(n, max_task_par()), n)});
+        }
+    }
+
+    // hello6-taskpar-dist
+    void benchmark_coforall_dist(std::vector<result>& results)
+    {
+        auto const locales = static_cast<std::int64_t>(chapel::numLocales());
+
+        for (std::int64_t n : tasksPerLocale)
+        {
+            // the tasks of all locales executed one after the other
+            coforall_2 const body{n};
+            double const serial = measure([&] {
+                for (std::int64_t i = 0; i != locales * n; ++i)
+                {
+                    body(i % n);
+                }
+            });
+
+            double const t =
+                measure([&] { chapel::coforall_locales(coforall_dist{n}); });
+
+            results.push_back({"coforall_dist", {{"tasksPerLocale", n}},
+                coforall_metrics(t, serial,
+                    locales * (std::min)(n, max_task_par()), locales * n)});
+        }
+    }
+
+    void write_results(std::ostream& os, std::vector<result> const& results)
+    {
+        os << "{\n";
+        os << "  \"numLocales\": " << chapel::numLocales() << ",\n";
+        os << "  \"workerThreads\": " << hpx::get_os_thread_count() << ",\n";
+        os << "  \"maxTaskPar\": " << chapel::here().maxTaskPar << ",\n";
+        os << "  \"repetitions\": " << repetitions << ",\n";
+        os << "  \"suppressOutput\": "
+           << (chapel::suppressOutput ? "true" : "false") << ",\n";
+        os << "  \"results\": [";
+
+        char const* sep = "\n";
+        for (result const& r : results)
+        {
+            os << sep << "    {\"benchmark\": \"" << r.benchmark << "\"";
+            for (auto const& p : r.params)
+            {
+                os << ", \"" << p.first << "\": " << p.second;
+            }
+            for (auto const& m : r.metrics)
+            {
+                // JSON has no representation of infinity or NaN
+                os << ", \"" << m.first << "\": ";
+                if (std::isfinite(m.second))
+                    os << m.second;
+                else
+                    os << "null";
+            }
+            os << "}";
+            sep = ",\n";
+        }
+
+        os << "\n  ]\n}\n";
+    }
+
+    void main()
+    {
+        std::vector<result> results;
+
+        benchmark_forall(results);
+        benchmark_coforall(results);
+        benchmark_forall_dist(results);
+        benchmark_coforall_dist(results);
+
+        if (benchmarkOutput == "-")
+        {
+            std::ostringstream os;
+            write_results(os, results);
+            hpx::cout << os.str() << hpx::flush;
+        }
+        else
+        {
+            std::ofstream os(benchmarkOutput);
+            write_results(os, results);
+        }
+    }
+}    // namespace overheads
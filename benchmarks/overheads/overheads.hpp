@@ -0,0 +1,16 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/program_options.hpp>
+
+namespace overheads {
+
+    hpx::program_options::options_description get_config_variables();
+
+    void main();
+}    // namespace overheads
@@ -0,0 +1,410 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_combinators.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/concurrency.hpp>
+#include <hpx/modules/futures.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/detail/instance_registry.hpp>
+#include <chapel/dist_array.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/locales.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Aggregation of fine-grained remote element accesses (`CopyAggregation`)
+//
+// Writing or reading individual elements of a distributed array on a remote
+// locale costs one message per element. An aggregator instead buffers the
+// operations per destination locale and sends each buffer as one bulk message
+// once it is full (see dstBuffSize and srcBuffSize) and when the aggregator
+// is flushed or destroyed. Failed operations are rethrown by flush() only,
+// the destructor reports them to std::cerr, thus code that has to handle
+// them must call flush() before the aggregator is destroyed. Aggregators
+// are not thread-safe, every task is expected to use an aggregator of its
+// own. Operations are not guaranteed to be performed before the aggregator
+// has been flushed. Updates sent by different aggregators are applied
+// concurrently, see aggregated_update() for what is (and is not)
+// synchronized.
+
+namespace chapel {
+
+    //
+    // The default operation of a DstAggregator, the destination element is
+    // overwritten with the new value.
+    //
+    template <typename T>
+    struct copy_op
+    {
+        T operator()(T const&, T const& rhs) const
+        {
+            return rhs;
+        }
+    };
+
+    namespace detail {
+
+        // Locks protecting the elements of types that can't be updated
+        // atomically, selected by the cache line holding the element
+        inline hpx::spinlock& element_mutex(void const* elem)
+        {
+            static hpx::util::cache_aligned_data<hpx::spinlock> mutexes[64];
+            return mutexes[(reinterpret_cast<std::uintptr_t>(elem) / 64) % 64]
+                .data_;
+        }
+
+        // Update `elem` to op(elem, value) such that concurrent updates of
+        // the same element by other aggregators are not lost: through
+        // std::atomic_ref if T supports lock-free atomics, otherwise by
+        // holding the lock of the element.
+        template <typename T, typename Op>
+        void combine_element(T& elem, T const& value, Op const& op)
+        {
+#if defined(__cpp_lib_atomic_ref)
+            if constexpr (std::is_trivially_copyable_v<T>)
+            {
+                if constexpr (std::atomic_ref<T>::is_always_lock_free &&
+                    alignof(T) >= std::atomic_ref<T>::required_alignment)
+                {
+                    std::atomic_ref<T> ref(elem);
+                    T current = ref.load(std::memory_order_relaxed);
+                    while (!ref.compare_exchange_weak(
+                        current, op(current, value), std::memory_order_relaxed))
+                    {
+                    }
+                    return;
+                }
+            }
+#endif
+            std::lock_guard<hpx::spinlock> l(element_mutex(&elem));
+            elem = op(elem, value);
+        }
+
+        // Apply a bulk message of updates to the local elements of an array.
+        // Messages from different aggregators are applied concurrently.
+        // Combining operations (e.g. histograms) update each element
+        // atomically with respect to all other aggregated updates, plain
+        // copies are simply stored. Neither is synchronized with accesses to
+        // the elements that don't go through an aggregator (e.g. set() or
+        // the body of a forall-loop), which must not overlap with the
+        // aggregated updates.
+        template <typename T, typename Op>
+        void aggregated_update(std::uint64_t id,
+            std::vector<std::int64_t> offsets, std::vector<T> values)
+        {
+            auto& data = get_instance<dist_array_storage<T>>(id);
+
+            if constexpr (std::is_same_v<Op, copy_op<T>>)
+            {
+                for (std::size_t i = 0; i != offsets.size(); ++i)
+                {
+                    data[offsets[i]] = std::move(values[i]);
+                }
+            }
+            else
+            {
+                Op op;
+                for (std::size_t i = 0; i != offsets.size(); ++i)
+                {
+                    combine_element<T>(data[offsets[i]], values[i], op);
+                }
+            }
+        }
+
+        template <typename T, typename Op>
+        struct aggregated_update_action
+          : hpx::actions::make_action<decltype(&aggregated_update<T, Op>),
+                &aggregated_update<T, Op>,
+                aggregated_update_action<T, Op>>::type
+        {
+        };
+
+        template <typename T>
+        std::vector<T> aggregated_get(
+            std::uint64_t id, std::vector<std::int64_t> offsets)
+        {
+            auto const& data = get_instance<dist_array_storage<T>>(id);
+
+            std::vector<T> values;
+            values.reserve(offsets.size());
+            for (std::int64_t offset : offsets)
+            {
+                values.push_back(data[offset]);
+            }
+            return values;
+        }
+
+        template <typename T>
+        struct aggregated_get_action
+          : hpx::actions::make_action<decltype(&aggregated_get<T>),
+                &aggregated_get<T>, aggregated_get_action<T>>::type
+        {
+        };
+    }    // namespace detail
+
+    //
+    // Aggregate writes to (possibly remote) elements of a distributed array,
+    // the element at index `idx` is updated to Op()(A[idx], value). `Op` has
+    // to be default constructible.
+    //
+    template <typename T, typename Dist, typename Op = copy_op<T>>
+    class DstAggregator
+    {
+    public:
+        explicit DstAggregator(
+            DistArray<T, Dist>& A, std::size_t buffer_size = dstBuffSize)
+          : dist_(A.dist())
+          , id_(A.id())
+          , buffer_size_(buffer_size != 0 ? buffer_size : 1)
+          , buffers_(dist_.num_locales())
+        {
+            for (std::uint32_t loc = 0; loc != dist_.num_locales(); ++loc)
+            {
+                buffers_[loc].indices = dist_.local(loc);
+            }
+        }
+
+        DstAggregator(DstAggregator const&) = delete;
+        DstAggregator& operator=(DstAggregator const&) = delete;
+
+        // flushes the remaining operations, failures are reported only
+        ~DstAggregator()
+        {
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+                detail::report_destructor_failure("chapel::DstAggregator",
+                    "flush the buffered operations", std::current_exception());
+            }
+        }
+
+        void copy(std::int64_t idx, T value)
+        {
+            std::uint32_t const owner = dist_.owner(idx);
+
+            buffer& b = buffers_[owner];
+            if (b.offsets.empty())
+            {
+                b.offsets.reserve(buffer_size_);
+                b.values.reserve(buffer_size_);
+            }
+
+            b.offsets.push_back(b.indices.offset(idx));
+            b.values.push_back(std::move(value));
+
+            if (b.offsets.size() >= buffer_size_)
+            {
+                send(owner);
+            }
+        }
+
+        // Send all buffered operations and wait for them to be performed
+        void flush()
+        {
+            for (std::uint32_t loc = 0; loc != buffers_.size(); ++loc)
+            {
+                if (!buffers_[loc].offsets.empty())
+                {
+                    send(loc);
+                }
+            }
+
+            hpx::wait_all(pending_);
+            std::vector<hpx::future<void>> pending = std::move(pending_);
+            pending_.clear();
+
+            for (auto& f : pending)
+            {
+                f.get();    // rethrow exceptions
+            }
+        }
+
+    private:
+        void send(std::uint32_t loc)
+        {
+            buffer& b = buffers_[loc];
+
+            std::vector<std::int64_t> offsets = std::move(b.offsets);
+            std::vector<T> values = std::move(b.values);
+            b.offsets.clear();
+            b.values.clear();
+
+            if (loc == here().id)
+            {
+                detail::aggregated_update<T, Op>(
+                    id_, std::move(offsets), std::move(values));
+                return;
+            }
+
+            detail::count_comm(detail::comm_op::execute_on);
+            pending_.push_back(
+                hpx::async<detail::aggregated_update_action<T, Op>>(
+                    hpx::naming::get_id_from_locality_id(loc), id_,
+                    std::move(offsets), std::move(values)));
+        }
+
+        struct buffer
+        {
+            local_indices indices;
+            std::vector<std::int64_t> offsets;
+            std::vector<T> values;
+        };
+
+        Dist dist_;
+        std::uint64_t id_;
+        std::size_t buffer_size_;
+        std::vector<buffer> buffers_;
+        std::vector<hpx::future<void>> pending_;
+    };
+
+    //
+    // Aggregate reads from (possibly remote) elements of a distributed array,
+    // `dst` is assigned the value of the element at index `idx`. The
+    // destinations have to stay valid (and must not be accessed) until the
+    // aggregator has been flushed.
+    //
+    template <typename T, typename Dist>
+    class SrcAggregator
+    {
+    public:
+        explicit SrcAggregator(
+            DistArray<T, Dist> const& A, std::size_t buffer_size = srcBuffSize)
+          : dist_(A.dist())
+          , id_(A.id())
+          , buffer_size_(buffer_size != 0 ? buffer_size : 1)
+          , local_(A.local_slice())
+          , buffers_(dist_.num_locales())
+        {
+            for (std::uint32_t loc = 0; loc != dist_.num_locales(); ++loc)
+            {
+                buffers_[loc].indices = dist_.local(loc);
+            }
+        }
+
+        SrcAggregator(SrcAggregator const&) = delete;
+        SrcAggregator& operator=(SrcAggregator const&) = delete;
+
+        // flushes the remaining operations, failures are reported only
+        ~SrcAggregator()
+        {
+            try
+            {
+                flush();
+            }
+            catch (...)
+            {
+                detail::report_destructor_failure("chapel::SrcAggregator",
+                    "flush the buffered operations", std::current_exception());
+            }
+        }
+
+        void copy(T& dst, std::int64_t idx)
+        {
+            std::uint32_t const owner = dist_.owner(idx);
+
+            buffer& b = buffers_[owner];
+            if (owner == here().id)
+            {
+                dst = local_[b.indices.offset(idx)];
+                return;
+            }
+
+            if (b.offsets.empty())
+            {
+                b.offsets.reserve(buffer_size_);
+                b.dsts.reserve(buffer_size_);
+            }
+
+            b.offsets.push_back(b.indices.offset(idx));
+            b.dsts.push_back(&dst);
+
+            if (b.offsets.size() >= buffer_size_)
+            {
+                send(owner);
+            }
+        }
+
+        // Send all buffered operations and wait for them to be performed
+        void flush()
+        {
+            for (std::uint32_t loc = 0; loc != buffers_.size(); ++loc)
+            {
+                if (!buffers_[loc].offsets.empty())
+                {
+                    send(loc);
+                }
+            }
+
+            std::vector<pending_get> pending = std::move(pending_);
+            pending_.clear();
+
+            for (auto& p : pending)
+            {
+                std::vector<T> values = p.values.get();
+                for (std::size_t i = 0; i != values.size(); ++i)
+                {
+                    *p.dsts[i] = std::move(values[i]);
+                }
+            }
+        }
+
+    private:
+        void send(std::uint32_t loc)
+        {
+            buffer& b = buffers_[loc];
+
+            detail::count_comm(detail::comm_op::execute_on);
+
+            pending_get p;
+            p.values = hpx::async<detail::aggregated_get_action<T>>(
+                hpx::naming::get_id_from_locality_id(loc), id_,
+                std::move(b.offsets));
+            p.dsts = std::move(b.dsts);
+            pending_.push_back(std::move(p));
+
+            b.offsets.clear();
+            b.dsts.clear();
+        }
+
+        struct buffer
+        {
+            local_indices indices;
+            std::vector<std::int64_t> offsets;
+            std::vector<T*> dsts;
+        };
+
+        struct pending_get
+        {
+            hpx::future<std::vector<T>> values;
+            std::vector<T*> dsts;
+        };
+
+        Dist dist_;
+        std::uint64_t id_;
+        std::size_t buffer_size_;
+        local_view<T> local_;
+        std::vector<buffer> buffers_;
+        std::vector<pending_get> pending_;
+    };
+}    // namespace chapel
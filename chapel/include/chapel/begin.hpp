@@ -0,0 +1,151 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/execution.hpp>
+#include <hpx/modules/executors.hpp>
+
+#include <chapel/detail/task_counter.hpp>
+
+#include <exception>
+#include <utility>
+
+// Chapel's `begin`, `cobegin`, and `sync` statements
+//
+//      sync {
+//          begin f();
+//          cobegin { g(); h(); }
+//      }
+//
+// is written as
+//
+//      chapel::sync_block([] {
+//          chapel::begin(f);
+//          chapel::cobegin(g, h);
+//      });
+//
+// A sync block waits for all tasks created by `begin` while it executes,
+// including the tasks created by those tasks (and by the tasks of coforall
+// and forall loops executed inside of it) on the current locale. Instead of
+// keeping a future per task, every sync block counts the tasks that have
+// not finished yet, so creating a task costs a single atomic increment.
+// Tasks created outside of any sync block are waited for before the runtime
+// shuts down. Exceptions thrown by the tasks are rethrown as an
+// hpx::exception_list at the end of the sync block (or cobegin).
+
+namespace chapel {
+
+    namespace detail {
+
+        // Run `f` as a new task that is counted by `counter` and belongs to
+        // the sync block `scope`, it inherits the loop name of the calling
+        // task
+        template <typename F>
+        void spawn_counted(task_counter& counter, task_counter* scope, F&& f)
+        {
+            task_context context = current_task_context();
+            context.scope = scope;
+
+            counter.add();
+
+            hpx::parallel::execution::post(
+                hpx::execution::parallel_executor(),
+                [&counter, context, f = std::forward<F>(f)]() mutable {
+                    scoped_task_context const inherited(context);
+
+                    try
+                    {
+                        f();
+                    }
+                    catch (...)
+                    {
+                        counter.error(std::current_exception());
+                    }
+                    counter.done();
+                });
+        }
+    }    // namespace detail
+
+    //
+    // Create a task executing `f()` and continue without waiting for it, the
+    // equivalent of
+    //
+    //      begin f();
+    //
+    // `f` is copied (or moved) into the task, anything it refers to has to
+    // stay alive until the enclosing sync block has finished.
+    //
+    template <typename F>
+    void begin(F&& f)
+    {
+        detail::task_counter& scope = detail::task_scope();
+        detail::spawn_counted(scope, &scope, std::forward<F>(f));
+    }
+
+    //
+    // Execute all of the given functions as distinct tasks and wait for
+    // them to finish, the equivalent of
+    //
+    //      cobegin { f(); fs(); ... }
+    //
+    // The first function is executed by the calling task. Tasks created by
+    // `begin` inside of the functions are not waited for (unless the cobegin
+    // is enclosed in a sync block).
+    //
+    template <typename F, typename... Fs>
+    void cobegin(F&& f, Fs&&... fs)
+    {
+        detail::task_counter counter(1);
+        detail::task_counter* scope = detail::get_task_scope();
+
+        (detail::spawn_counted(counter, scope, std::forward<Fs>(fs)), ...);
+
+        try
+        {
+            f();
+        }
+        catch (...)
+        {
+            counter.error(std::current_exception());
+        }
+
+        counter.done();
+        counter.wait();
+    }
+
+    //
+    // Execute `f()` and wait for all tasks created (directly or indirectly)
+    // by it, the equivalent of
+    //
+    //      sync { f(); }
+    //
+    // Must be invoked from an HPX thread.
+    //
+    template <typename F>
+    void sync_block(F&& f)
+    {
+        detail::task_counter counter(1);
+
+        {
+            detail::task_context context = detail::current_task_context();
+            context.scope = &counter;
+            detail::scoped_task_context const inner(context);
+
+            try
+            {
+                f();
+            }
+            catch (...)
+            {
+                counter.error(std::current_exception());
+            }
+        }
+
+        counter.done();
+        counter.wait();
+    }
+}    // namespace chapel
@@ -0,0 +1,142 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/execution.hpp>
+#include <hpx/modules/executors.hpp>
+#include <hpx/modules/synchronization.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/detail/loop_trace.hpp>
+#include <chapel/detail/task_counter.hpp>
+#include <chapel/locales.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+namespace chapel {
+
+    namespace detail {
+
+        // Schedule the task on the cores of the NUMA domain of `s`
+        inline hpx::threads::thread_schedule_hint schedule_hint(
+            sublocale const& s)
+        {
+            return hpx::threads::thread_schedule_hint(
+                hpx::threads::thread_schedule_hint_mode::numa,
+                static_cast<std::int16_t>(s.numaDomain));
+        }
+
+        // Create a task running f(i) for every i in [first, last) and wait
+        // for all of them, the task running iteration `i` is scheduled
+        // according to hint(i)
+        template <typename Hint, typename F>
+        void spawn_tasks(hpx::threads::thread_stacksize stacksize,
+            std::int64_t first, std::int64_t last, Hint&& hint, F&& f)
+        {
+            if (first >= last)
+                return;
+
+            hpx::latch l(static_cast<std::ptrdiff_t>(last - first + 1));
+
+            hpx::spinlock mtx;
+            hpx::exception_list errors;
+
+            // tasks created by `begin` inside of the loop body belong to the
+            // same sync block as the loop itself, and nested loops are named
+            // after the loop
+            task_context const context = current_task_context();
+
+            for (std::int64_t i = first; i != last; ++i)
+            {
+                hpx::execution::parallel_executor exec(
+                    hpx::threads::thread_priority::default_, stacksize,
+                    hint(i));
+
+                hpx::parallel::execution::post(exec, [&, i]() {
+                    scoped_task_context const inherited(context);
+
+                    try
+                    {
+                        f(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<hpx::spinlock> g(mtx);
+                        errors.add(std::current_exception());
+                    }
+                    l.count_down(1);
+                });
+            }
+
+            l.arrive_and_wait();
+
+            if (errors.size() != 0)
+            {
+                throw errors;
+            }
+        }
+
+        // The NUMA domain a task scheduled according to `hint` is placed on
+        inline std::uint32_t placement(
+            hpx::threads::thread_schedule_hint const& hint)
+        {
+            return hint.mode == hpx::threads::thread_schedule_hint_mode::numa ?
+                static_cast<std::uint32_t>(hint.hint) :
+                loop_trace::not_placed;
+        }
+
+        // The implementation of coforall(), the task running iteration `i`
+        // is scheduled according to hint(i)
+        template <typename Hint, typename F>
+        void coforall_hinted(hpx::threads::thread_stacksize stacksize,
+            std::int64_t first, std::int64_t last, Hint&& hint, F&& f)
+        {
+            std::int64_t const count = last > first ? last - first : 0;
+            loop_trace trace(
+                loop_kind::coforall, count, static_cast<std::size_t>(count));
+
+            spawn_tasks(stacksize, first, last, hint, [&](std::int64_t i) {
+                loop_trace::task_timer timer(trace, 1,
+                    trace.active() ? placement(hint(i)) :
+                                     loop_trace::not_placed);
+                f(i);
+            });
+        }
+    }    // namespace detail
+
+    //
+    // A coforall-loop creates a distinct task per iteration and waits for all
+    // of them to finish. Unlike a forall-loop there is no partitioning of the
+    // iterations to be done, thus every task is directly spawned as a
+    // lightweight HPX thread and all of them are joined using a single latch.
+    //
+    // Bodies that are very small and never suspend may run on small stacks
+    // (thread_stacksize::small_) or on stackless threads
+    // (thread_stacksize::nostack), which further reduces the cost of creating
+    // the tasks. Exceptions thrown by the tasks are collected and rethrown as
+    // an hpx::exception_list once all tasks have finished.
+    //
+    template <typename F>
+    void coforall(hpx::threads::thread_stacksize stacksize, std::int64_t first,
+        std::int64_t last, F&& f)
+    {
+        detail::coforall_hinted(
+            stacksize, first, last,
+            [](std::int64_t) { return hpx::threads::thread_schedule_hint(); },
+            f);
+    }
+
+    template <typename F>
+    void coforall(std::int64_t first, std::int64_t last, F&& f)
+    {
+        coforall(hpx::threads::thread_stacksize::default_, first, last, f);
+    }
+}    // namespace chapel
@@ -0,0 +1,180 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_combinators.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/locales.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace chapel {
+
+    namespace detail {
+
+        template <typename F>
+        void spawn_tree(std::uint32_t root, std::uint32_t first,
+            std::uint32_t last, std::uint32_t arity, F f);
+
+        template <typename F>
+        struct spawn_tree_action
+          : hpx::actions::make_action<decltype(&spawn_tree<F>),
+                &spawn_tree<F>, spawn_tree_action<F>>::type
+        {
+        };
+
+        // The locales are numbered relative to the root of the spawn tree,
+        // i.e. rank r corresponds to the locale (root + r) % numLocales.
+        inline std::uint32_t locale_of_rank(
+            std::uint32_t root, std::uint32_t rank)
+        {
+            return static_cast<std::uint32_t>(
+                (std::uint64_t(root) + rank) % numLocales());
+        }
+
+        // Executed on the locale of rank `first`, which is responsible for
+        // running `f` on all locales of rank [first, last). The remaining
+        // ranks [first + 1, last) are split into (at most) `arity` equally
+        // sized subtrees, each of which is handed to the locale of its first
+        // rank. This returns only after all locales of the subtree are done.
+        template <typename F>
+        void spawn_tree(std::uint32_t root, std::uint32_t first,
+            std::uint32_t last, std::uint32_t arity, F f)
+        {
+            std::uint64_t const count = last - first - 1;
+            std::uint64_t const subtrees =
+                (std::min)(std::uint64_t((std::max)(arity, 1u)), count);
+
+            std::vector<hpx::future<void>> children;
+            children.reserve(subtrees);
+
+            for (std::uint64_t i = 0; i != subtrees; ++i)
+            {
+                auto const lo = static_cast<std::uint32_t>(
+                    first + 1 + i * count / subtrees);
+                auto const hi = static_cast<std::uint32_t>(
+                    first + 1 + (i + 1) * count / subtrees);
+
+                count_comm(comm_op::execute_on_nb);
+                children.push_back(hpx::async<spawn_tree_action<F>>(
+                    hpx::naming::get_id_from_locality_id(
+                        locale_of_rank(root, lo)),
+                    root, lo, hi, arity, f));
+            }
+
+            f(here());
+
+            hpx::wait_all(children);
+            for (auto& child : children)
+            {
+                child.get();    // rethrow exceptions
+            }
+        }
+
+        template <typename F>
+        void spawn_subset_tree(
+            std::vector<std::uint32_t> locales, std::uint32_t arity, F f);
+
+        template <typename F>
+        struct spawn_subset_tree_action
+          : hpx::actions::make_action<decltype(&spawn_subset_tree<F>),
+                &spawn_subset_tree<F>, spawn_subset_tree_action<F>>::type
+        {
+        };
+
+        // Same as spawn_tree(), except that the tree spans the given
+        // locales only. Executed on locales[0], every subtree receives the
+        // list of its own locales.
+        template <typename F>
+        void spawn_subset_tree(
+            std::vector<std::uint32_t> locales, std::uint32_t arity, F f)
+        {
+            std::uint64_t const count = locales.size() - 1;
+            std::uint64_t const subtrees =
+                (std::min)(std::uint64_t((std::max)(arity, 1u)), count);
+
+            std::vector<hpx::future<void>> children;
+            children.reserve(subtrees);
+
+            for (std::uint64_t i = 0; i != subtrees; ++i)
+            {
+                auto const lo = locales.begin() + 1 + i * count / subtrees;
+                auto const hi =
+                    locales.begin() + 1 + (i + 1) * count / subtrees;
+
+                count_comm(comm_op::execute_on_nb);
+                children.push_back(hpx::async<spawn_subset_tree_action<F>>(
+                    hpx::naming::get_id_from_locality_id(*lo),
+                    std::vector<std::uint32_t>(lo, hi), arity, f));
+            }
+
+            f(here());
+
+            hpx::wait_all(children);
+            for (auto& child : children)
+            {
+                child.get();    // rethrow exceptions
+            }
+        }
+    }    // namespace detail
+
+    //
+    // Run `f(loc)` as a distinct task on every locale `loc`, which is the
+    // equivalent of
+    //
+    //      coforall loc in Locales do on loc { f(loc); }
+    //
+    // Instead of launching all tasks from the calling locale, the tasks are
+    // fanned out through a spawn tree with `arity` children per node, and the
+    // completion of the tasks is gathered back up the same tree. This makes
+    // the latency of the construct (and the load on the calling locale)
+    // logarithmic in the number of locales. The function object `f` has to
+    // be serializable.
+    //
+    template <typename F>
+    void coforall_locales(F const& f, std::uint32_t arity = spawnTreeArity)
+    {
+        detail::spawn_tree(here().id, 0, numLocales(), arity, f);
+    }
+
+    //
+    // Run `f(loc)` as a distinct task on every locale listed in `locales`
+    // (each of which must be listed at most once) through a spawn tree
+    // spanning only these locales, no other locale receives any message.
+    //
+    template <typename F>
+    void coforall_locales(std::vector<std::uint32_t> locales, F const& f,
+        std::uint32_t arity = spawnTreeArity)
+    {
+        if (locales.empty())
+            return;
+
+        // the calling locale becomes the root of the tree if it takes part
+        auto const it = std::find(locales.begin(), locales.end(), here().id);
+        if (it != locales.end())
+        {
+            std::iter_swap(locales.begin(), it);
+            detail::spawn_subset_tree(std::move(locales), arity, f);
+            return;
+        }
+
+        detail::count_comm(detail::comm_op::execute_on_nb);
+        std::uint32_t const root = locales[0];
+        hpx::async<detail::spawn_subset_tree_action<F>>(
+            hpx::naming::get_id_from_locality_id(root), std::move(locales),
+            arity, f)
+            .get();
+    }
+}    // namespace chapel
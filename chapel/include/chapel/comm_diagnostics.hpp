@@ -0,0 +1,104 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chapel/detail/comm_diagnostics.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// Communication diagnostics (Chapel's `CommDiagnostics` module)
+//
+//      startCommDiagnostics();
+//      forall i in D do ...;
+//      stopCommDiagnostics();
+//      writeln(getCommDiagnostics());
+//
+// Between start and stop, every locale counts the remote operations it
+// initiates:
+//
+//  - get:           reads of remote elements of a DistArray
+//  - put:           writes of remote elements of a DistArray
+//  - execute_on:    other remote invocations that are waited for (e.g. the
+//                   bulk messages sent by aggregators), and the collective
+//                   operations of distributed reductions and scans (one per
+//                   participating locale)
+//  - execute_on_nb: tasks created on other locales (e.g. by the spawn tree
+//                   of coforall_locales and distributed forall-loops)
+//
+// Additionally, the number of parcels and bytes sent by the locale are taken
+// from HPX's performance counters (/parcels/count/sent, /data/count/sent),
+// which covers all communication.
+//
+// The counts of all operations since the runtime started are available as
+// the HPX performance counters /chapel{locality#N/total}/comm/get, .../put,
+// .../execute_on, and .../execute_on_nb, e.g. for --hpx:print-counter.
+//
+// The operations controlling the diagnostics of all locales (start, stop,
+// reset, get) send one message to every locale, their own parcels are not
+// excluded from the counts.
+
+namespace chapel {
+
+    struct commDiagnostics
+    {
+        std::uint64_t get = 0;
+        std::uint64_t put = 0;
+        std::uint64_t execute_on = 0;
+        std::uint64_t execute_on_nb = 0;
+        std::uint64_t parcels = 0;
+        std::uint64_t bytes = 0;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & get & put & execute_on & execute_on_nb & parcels & bytes;
+            // clang-format on
+        }
+    };
+
+    // Start, stop, and reset collecting diagnostics on all locales
+    void startCommDiagnostics();
+    void stopCommDiagnostics();
+    void resetCommDiagnostics();
+
+    // Return the diagnostics of all locales, indexed by locale ID
+    std::vector<commDiagnostics> getCommDiagnostics();
+
+    // Write the diagnostics of all locales as a table to the console
+    void printCommDiagnosticsTable();
+
+    // Same as above, but for the current locale only (no communication)
+    void startCommDiagnosticsHere();
+    void stopCommDiagnosticsHere();
+    void resetCommDiagnosticsHere();
+    commDiagnostics getCommDiagnosticsHere();
+
+    //
+    // Collect diagnostics on all locales for the lifetime of this object,
+    // the counts are reset at construction time.
+    //
+    class comm_diagnostics_region
+    {
+    public:
+        comm_diagnostics_region()
+        {
+            resetCommDiagnostics();
+            startCommDiagnostics();
+        }
+
+        comm_diagnostics_region(comm_diagnostics_region const&) = delete;
+        comm_diagnostics_region& operator=(
+            comm_diagnostics_region const&) = delete;
+
+        ~comm_diagnostics_region()
+        {
+            stopCommDiagnostics();
+        }
+    };
+}    // namespace chapel
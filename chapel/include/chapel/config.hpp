@@ -0,0 +1,126 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/program_options.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Configuration constants controlling the Chapel runtime support. As all
+// other config constants, they can be overridden on the command line (e.g.,
+// ``./hello --spawnTreeArity=2``), provided that the options returned from
+// get_config_variables() have been added to the command line description.
+//
+// Similar to a Chapel `config param`, each of them can instead be fixed at
+// compile time by defining CHAPEL_PARAM_<name> (see the CMake option
+// CHAPEL_HPX_PARAMS), in which case it becomes a constexpr constant that can
+// no longer be set on the command line.
+
+namespace chapel {
+
+    hpx::program_options::options_description get_config_variables();
+
+    //
+    // Number of children of each node of the tree used to spawn tasks on all
+    // locales (see coforall_locales())
+    //
+#if defined(CHAPEL_PARAM_spawnTreeArity)
+    inline constexpr std::uint32_t spawnTreeArity =
+        CHAPEL_PARAM_spawnTreeArity;
+#else
+    extern std::uint32_t spawnTreeArity;
+#endif
+
+    //
+    // Number of remote operations buffered per destination locale by
+    // DstAggregator and SrcAggregator before they are sent as a single message
+    //
+#if defined(CHAPEL_PARAM_dstBuffSize)
+    inline constexpr std::size_t dstBuffSize =
+        CHAPEL_PARAM_dstBuffSize;
+#else
+    extern std::size_t dstBuffSize;
+#endif
+#if defined(CHAPEL_PARAM_srcBuffSize)
+    inline constexpr std::size_t srcBuffSize =
+        CHAPEL_PARAM_srcBuffSize;
+#else
+    extern std::size_t srcBuffSize;
+#endif
+
+    //
+    // Number of tasks used to execute a forall-loop on each locale, zero
+    // stands for here().maxTaskPar
+    //
+#if defined(CHAPEL_PARAM_dataParTasksPerLocale)
+    inline constexpr std::uint32_t dataParTasksPerLocale =
+        CHAPEL_PARAM_dataParTasksPerLocale;
+#else
+    extern std::uint32_t dataParTasksPerLocale;
+#endif
+
+    //
+    // If false, the number of tasks used to execute a forall-loop is reduced
+    // by the number of tasks which are already running on the locale
+    //
+#if defined(CHAPEL_PARAM_dataParIgnoreRunningTasks)
+    inline constexpr bool dataParIgnoreRunningTasks =
+        CHAPEL_PARAM_dataParIgnoreRunningTasks;
+#else
+    extern bool dataParIgnoreRunningTasks;
+#endif
+
+    //
+    // Minimal number of iterations executed by each of the tasks of a
+    // forall-loop, loops with fewer iterations are executed serially
+    //
+#if defined(CHAPEL_PARAM_dataParMinGranularity)
+    inline constexpr std::int64_t dataParMinGranularity =
+        CHAPEL_PARAM_dataParMinGranularity;
+#else
+    extern std::int64_t dataParMinGranularity;
+#endif
+
+    //
+    // If true, writeln() discards its arguments instead of writing them to
+    // the console (e.g. to keep I/O out of benchmark measurements)
+    //
+#if defined(CHAPEL_PARAM_suppressOutput)
+    inline constexpr bool suppressOutput = CHAPEL_PARAM_suppressOutput;
+#else
+    extern bool suppressOutput;
+#endif
+
+    //
+    // If true, every locale collects communication diagnostics for the whole
+    // run and prints them before the runtime shuts down (see
+    // comm_diagnostics.hpp)
+    //
+#if defined(CHAPEL_PARAM_printCommDiagnostics)
+    inline constexpr bool printCommDiagnostics =
+        CHAPEL_PARAM_printCommDiagnostics;
+#else
+    extern bool printCommDiagnostics;
+#endif
+
+    //
+    // If true, every forall- and coforall-loop is traced, the last
+    // traceBufferSize records of every locale are kept (see loop_trace.hpp)
+    //
+#if defined(CHAPEL_PARAM_traceLoops)
+    inline constexpr bool traceLoops = CHAPEL_PARAM_traceLoops;
+#else
+    extern bool traceLoops;
+#endif
+#if defined(CHAPEL_PARAM_traceBufferSize)
+    inline constexpr std::size_t traceBufferSize =
+        CHAPEL_PARAM_traceBufferSize;
+#else
+    extern std::size_t traceBufferSize;
+#endif
+}    // namespace chapel
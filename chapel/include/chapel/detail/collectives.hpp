@@ -0,0 +1,27 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/collectives.hpp>
+
+#include <cstddef>
+
+namespace chapel::detail {
+
+    // The communicator spanning all locales that is used by the distributed
+    // reductions and scans. It is created on first use on each locale.
+    hpx::collectives::communicator get_locales_communicator();
+
+    // Return the generation to use for the next collective operation on the
+    // communicator returned by get_locales_communicator(). The locale
+    // initiating a distributed operation passes it on to all participating
+    // locales. Generations are handed out by locale #0 (in the same way as
+    // instance IDs, see instance_registry.hpp), thus operations initiated by
+    // different locales never use the same generation. This may have to
+    // communicate with locale #0.
+    std::size_t next_collective_generation();
+}    // namespace chapel::detail
@@ -0,0 +1,27 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstdint>
+
+namespace chapel::detail {
+
+    // The kinds of remote operations counted by the communication
+    // diagnostics (see comm_diagnostics.hpp)
+    enum class comm_op : std::uint8_t
+    {
+        get = 0,              // read of a remote element
+        put = 1,              // write of a remote element
+        execute_on = 2,       // (blocking) remote invocation
+        execute_on_nb = 3,    // remote task creation (fork)
+    };
+
+    // Count a remote operation initiated by this locale. The counts are
+    // always maintained (a relaxed atomic increment), they are exposed as
+    // HPX performance counters and through the diagnostics regions.
+    void count_comm(comm_op op);
+}    // namespace chapel::detail
@@ -0,0 +1,139 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/detail/loop_trace.hpp>
+#include <chapel/locales.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace chapel::detail {
+
+    // The number of tasks used to execute a forall-loop over `count`
+    // iterations on the current locale (Chapel's `_computeNumChunks`):
+    //
+    //  - start with dataParTasksPerLocale tasks (here().maxTaskPar if zero),
+    //  - unless dataParIgnoreRunningTasks is set, subtract the number of
+    //    tasks that are already running on the locale (other than the
+    //    calling one), but keep at least one task,
+    //  - give every task at least dataParMinGranularity iterations.
+    //
+    // A result of one means that the loop is executed serially by the
+    // calling task.
+    inline std::size_t forall_num_tasks(std::int64_t count)
+    {
+        if (count <= 0)
+            return 0;
+
+        std::int64_t num_tasks = dataParTasksPerLocale != 0 ?
+            std::int64_t(dataParTasksPerLocale) :
+            static_cast<std::int64_t>(here().maxTaskPar);
+
+        if (!dataParIgnoreRunningTasks)
+        {
+            std::int64_t const running = hpx::threads::get_thread_count(
+                hpx::threads::thread_schedule_state::active);
+            num_tasks = (std::max)(std::int64_t(1), num_tasks - running + 1);
+        }
+
+        if (dataParMinGranularity > 1)
+        {
+            num_tasks = (std::min)(num_tasks, count / dataParMinGranularity);
+        }
+
+        return static_cast<std::size_t>(
+            (std::max)(std::int64_t(1), (std::min)(num_tasks, count)));
+    }
+
+    // The sublocale (NUMA domain) running task `task` of `num_tasks` tasks.
+    // The tasks are assigned to the sublocales in order, proportionally to
+    // the number of cores of each, thus a given chunk of the iterations of a
+    // loop is always executed on the same NUMA domain (as long as the number
+    // of tasks doesn't change), which keeps the accesses to data that was
+    // first touched by an earlier loop local to the NUMA domain.
+    inline sublocale const& sublocale_of_task(
+        std::size_t task, std::size_t num_tasks)
+    {
+        auto const& children = here().children;
+
+        std::size_t const slot = task * here().maxTaskPar / num_tasks;
+        std::size_t bound = 0;
+        for (sublocale const& child : children)
+        {
+            bound += child.maxTaskPar;
+            if (slot < bound)
+                return child;
+        }
+        return children.back();
+    }
+
+    // Split [first, last) into `num_tasks` contiguous chunks of (almost)
+    // equal size and invoke `f(task, lo, hi)` for each of them as a distinct
+    // task. This is the equivalent of the leader iterator of a Chapel range.
+    // A single chunk is executed directly by the calling task. On locales
+    // with more than one NUMA domain the chunks are first split between the
+    // NUMA domains, every task runs on the cores of its NUMA domain.
+    template <typename F>
+    void forall_tasks(
+        std::int64_t first, std::int64_t last, std::size_t num_tasks, F&& f)
+    {
+        std::int64_t const count = last > first ? last - first : 0;
+        loop_trace trace(loop_kind::forall, count, num_tasks);
+
+        if (num_tasks == 1)
+        {
+            loop_trace::task_timer timer(trace, count);
+            f(std::size_t(0), first, last);
+            return;
+        }
+
+        auto const tasks = static_cast<std::int64_t>(num_tasks);
+
+        // the trace counts the tasks that ran outside of the NUMA domain
+        // they were placed on
+        auto const run_chunk = [&](std::int64_t task,
+                                   std::uint32_t numa_domain) {
+            std::int64_t const lo = first + task * count / tasks;
+            std::int64_t const hi = first + (task + 1) * count / tasks;
+
+            loop_trace::task_timer timer(trace, hi - lo, numa_domain);
+            f(static_cast<std::size_t>(task), lo, hi);
+        };
+
+        if (here().getChildCount() <= 1)
+        {
+            spawn_tasks(
+                hpx::threads::thread_stacksize::default_, 0, tasks,
+                [](std::int64_t) {
+                    return hpx::threads::thread_schedule_hint();
+                },
+                [&](std::int64_t task) {
+                    run_chunk(task, loop_trace::not_placed);
+                });
+            return;
+        }
+
+        spawn_tasks(
+            hpx::threads::thread_stacksize::default_, 0, tasks,
+            [&](std::int64_t task) {
+                return schedule_hint(sublocale_of_task(
+                    static_cast<std::size_t>(task), num_tasks));
+            },
+            [&](std::int64_t task) {
+                run_chunk(task,
+                    sublocale_of_task(static_cast<std::size_t>(task), num_tasks)
+                        .numaDomain);
+            });
+    }
+}    // namespace chapel::detail
@@ -0,0 +1,137 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chapel/coforall_locales.hpp>
+#include <chapel/locales.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+
+// Every locale keeps a table of the objects that are instantiated once per
+// locale on behalf of a distributed object (e.g. the local storage of a
+// distributed array, or a privatized object). The table is keyed by an ID
+// that is unique across all locales, which allows tasks to reach the local
+// instance without resolving a global address. IDs are small integers handed
+// out by locale #0, which allows for the table to be a (chunked) array that
+// is read without taking any locks. The IDs of released objects are handed
+// out again, thus the table only grows with the number of live objects.
+
+namespace chapel::detail {
+
+    // Return a new ID that is unique across all locales, this may have to
+    // communicate with locale #0
+    std::uint64_t next_instance_id();
+
+    // Make `id` available to next_instance_id() again, the instances `id`
+    // must have been unregistered on all locales
+    void release_instance_id(std::uint64_t id);
+
+    void register_instance(std::uint64_t id, std::shared_ptr<void> instance);
+    void unregister_instance(std::uint64_t id);
+
+    // Report that a destructor of `type` failed to `action` (to std::cerr),
+    // destructors must not throw
+    void report_destructor_failure(char const* type, char const* action,
+        std::exception_ptr const& e) noexcept;
+
+    // Return the instance registered for `id` on this locale
+    void* get_instance(std::uint64_t id);
+
+    template <typename T>
+    T& get_instance(std::uint64_t id)
+    {
+        return *static_cast<T*>(get_instance(id));
+    }
+
+    template <typename F>
+    struct create_instance
+    {
+        void operator()(locale const& loc) const
+        {
+            register_instance(id, make(loc));
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & id & make;
+            // clang-format on
+        }
+
+        std::uint64_t id = 0;
+        F make;
+    };
+
+    struct destroy_instance
+    {
+        void operator()(locale const&) const
+        {
+            unregister_instance(id);
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & id;
+            // clang-format on
+        }
+
+        std::uint64_t id = 0;
+    };
+
+    //
+    // Register the instance returned by make(loc) (a std::shared_ptr) on
+    // every locale `loc` under a new ID, and return the ID. The function
+    // object `make` has to be serializable.
+    //
+    template <typename F>
+    std::uint64_t create_instances(F const& make)
+    {
+        std::uint64_t const id = next_instance_id();
+        coforall_locales(create_instance<F>{id, make});
+        return id;
+    }
+
+    //
+    // Unregister the instances `id` on all locales (if `id` is not zero),
+    // release the ID, and reset `id` to zero. This communicates with all
+    // locales and may throw.
+    //
+    inline void release_instances(std::uint64_t& id)
+    {
+        if (id != 0)
+        {
+            std::uint64_t const released = std::exchange(id, 0);
+            coforall_locales(destroy_instance{released});
+            release_instance_id(released);
+        }
+    }
+
+    //
+    // Same as release_instances(), for use in destructors: failures are
+    // reported instead of thrown, the instances on the locales that could
+    // not be reached (and their ID) are leaked.
+    //
+    inline void release_instances(std::uint64_t& id, char const* type) noexcept
+    {
+        try
+        {
+            release_instances(id);
+        }
+        catch (...)
+        {
+            report_destructor_failure(type,
+                "release the instances on all locales",
+                std::current_exception());
+        }
+    }
+}    // namespace chapel::detail
@@ -0,0 +1,135 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/timing.hpp>
+
+#include <chapel/config.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace chapel::detail {
+
+    enum class loop_kind : std::uint8_t
+    {
+        forall,
+        coforall
+    };
+
+    // A record stored in the trace buffer of a locale, either describing a
+    // whole loop (worker == loop_record) or one of its tasks
+    struct trace_event
+    {
+        static constexpr std::uint32_t loop_record = ~std::uint32_t(0);
+
+        std::uint64_t loop = 0;
+        loop_kind kind = loop_kind::forall;
+        std::uint32_t worker = loop_record;
+        std::uint64_t start = 0;    // ns
+        std::uint64_t end = 0;      // ns
+        std::int64_t iterations = 0;
+
+        // loop records only
+        char name[48] = {};
+        std::uint64_t tasks = 0;
+        std::int64_t min_chunk = 0;
+        std::int64_t max_chunk = 0;
+        std::uint64_t busy = 0;         // ns, summed over all tasks
+        std::uint64_t max_busy = 0;     // ns, longest task
+        std::uint64_t misplaced = 0;    // tasks run on another NUMA domain
+    };
+
+    void record_trace_event(trace_event const& e);
+
+    // The trace of a single forall- or coforall-loop, created by the task
+    // executing the loop. Does nothing unless traceLoops is set.
+    class loop_trace
+    {
+    public:
+        loop_trace(loop_kind kind, std::int64_t iterations, std::size_t tasks)
+          : active_(traceLoops)
+        {
+            if (active_)
+            {
+                start(kind, iterations, tasks);
+            }
+        }
+
+        loop_trace(loop_trace const&) = delete;
+        loop_trace& operator=(loop_trace const&) = delete;
+
+        ~loop_trace()
+        {
+            if (active_)
+            {
+                finish();
+            }
+        }
+
+        bool active() const
+        {
+            return active_;
+        }
+
+        // Passed as the NUMA domain of tasks that were not placed on any
+        static constexpr std::uint32_t not_placed = ~std::uint32_t(0);
+
+        // Times a task of the loop executing `iterations` iterations, which
+        // was placed on the NUMA domain `numa_domain`
+        class task_timer
+        {
+        public:
+            task_timer(loop_trace& trace, std::int64_t iterations,
+                std::uint32_t numa_domain = not_placed)
+              : trace_(trace.active() ? &trace : nullptr)
+              , iterations_(iterations)
+              , numa_domain_(numa_domain)
+              , start_(trace_ != nullptr ?
+                        hpx::chrono::high_resolution_clock::now() :
+                        0)
+            {
+            }
+
+            task_timer(task_timer const&) = delete;
+            task_timer& operator=(task_timer const&) = delete;
+
+            ~task_timer()
+            {
+                if (trace_ != nullptr)
+                {
+                    trace_->task_done(start_, iterations_, numa_domain_);
+                }
+            }
+
+        private:
+            loop_trace* trace_;
+            std::int64_t iterations_;
+            std::uint32_t numa_domain_;
+            std::uint64_t start_;
+        };
+
+    private:
+        void start(loop_kind kind, std::int64_t iterations, std::size_t tasks);
+        void task_done(std::uint64_t start, std::int64_t iterations,
+            std::uint32_t numa_domain);
+        void finish();
+
+        bool const active_;
+
+        trace_event loop_;
+
+        std::atomic<std::uint64_t> busy_{0};
+        std::atomic<std::uint64_t> max_busy_{0};
+        std::atomic<std::int64_t> min_chunk_{
+            (std::numeric_limits<std::int64_t>::max)()};
+        std::atomic<std::int64_t> max_chunk_{0};
+        std::atomic<std::uint64_t> misplaced_{0};
+    };
+}    // namespace chapel::detail
@@ -0,0 +1,107 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+
+namespace chapel::detail {
+
+    // Termination detection for the tasks created by `begin`. Every task is
+    // counted when it is created and uncounted once it has finished, waiting
+    // for the tasks amounts to waiting for the counter to drop to zero.
+    // Only the decrement that may reach zero takes the lock, which allows
+    // for the counter to be destroyed as soon as wait() has returned.
+    class task_counter
+    {
+    public:
+        explicit task_counter(std::int64_t count = 0)
+          : count_(count)
+        {
+        }
+
+        task_counter(task_counter const&) = delete;
+        task_counter& operator=(task_counter const&) = delete;
+
+        void add()
+        {
+            count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void done();
+
+        // Record an exception thrown by one of the counted tasks
+        void error(std::exception_ptr e);
+
+        // Wait for the counter to drop to zero, rethrow the exceptions
+        // thrown by the tasks as an hpx::exception_list
+        void wait();
+
+    private:
+        std::atomic<std::int64_t> count_;
+        hpx::spinlock mtx_;
+        hpx::condition_variable_any cv_;
+        hpx::exception_list errors_;
+    };
+
+    // What a task inherits from the task that created it: the counter of
+    // the innermost sync block it belongs to, and the name of its loops (see
+    // loop_name in loop_trace.hpp)
+    struct task_context
+    {
+        task_counter* scope = nullptr;
+        char const* loop_name = nullptr;
+    };
+
+    // The context of the calling task, empty if none has been set
+    task_context current_task_context();
+
+    // Make `context` the context of the calling task, returns the previous
+    // one. The context is referenced (not copied) and has to stay alive
+    // until it is replaced again.
+    task_context const* set_task_context(task_context const* context);
+
+    // Makes a copy of `context` the context of the calling task while the
+    // object exists
+    class scoped_task_context
+    {
+    public:
+        explicit scoped_task_context(task_context const& context)
+          : context_(context)
+          , previous_(set_task_context(&context_))
+        {
+        }
+
+        scoped_task_context(scoped_task_context const&) = delete;
+        scoped_task_context& operator=(scoped_task_context const&) = delete;
+
+        ~scoped_task_context()
+        {
+            set_task_context(previous_);
+        }
+
+    private:
+        task_context const context_;
+        task_context const* const previous_;
+    };
+
+    // The counter of the innermost sync block the calling task belongs to,
+    // nullptr if none
+    inline task_counter* get_task_scope()
+    {
+        return current_task_context().scope;
+    }
+
+    // The counter of the innermost sync block the calling task belongs to,
+    // or the counter of all tasks that don't belong to any sync block (which
+    // is waited for before the runtime shuts down)
+    task_counter& task_scope();
+}    // namespace chapel::detail
@@ -0,0 +1,342 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/futures.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+
+#include <chapel/coforall_locales.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/detail/instance_registry.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/forall.hpp>
+#include <chapel/locales.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Distributed arrays
+//
+// A `DistArray<T, Dist>` stores its elements on the locales owning the
+// corresponding indices of the distribution `Dist`. Each locale holds its
+// elements contiguously, in the order of its local indices (see
+// local_indices). A forall-loop over a distributed array executes every
+// iteration on the locale owning the element and hands the element to the
+// loop body by reference (owner computes). The elements owned by the calling
+// locale are directly accessible through local_slice().
+
+namespace chapel {
+
+    //
+    // The elements of a distributed array owned by one locale
+    //
+    template <typename T>
+    class local_view
+    {
+    public:
+        local_view() = default;
+
+        local_view(local_indices const& indices, T* data)
+          : indices_(indices)
+          , data_(data)
+        {
+        }
+
+        std::int64_t size() const
+        {
+            return indices_.size();
+        }
+
+        // The (global) index of the k'th local element
+        std::int64_t index(std::int64_t k) const
+        {
+            return indices_[k];
+        }
+
+        // The k'th local element, 0 <= k < size()
+        T& operator[](std::int64_t k) const
+        {
+            return data_[k];
+        }
+
+        T* begin() const
+        {
+            return data_;
+        }
+        T* end() const
+        {
+            return data_ + indices_.size();
+        }
+
+        local_indices const& indices() const
+        {
+            return indices_;
+        }
+
+    private:
+        local_indices indices_;
+        T* data_ = nullptr;
+    };
+
+    namespace detail {
+
+        // The elements owned by one locale. Unlike std::vector this stores
+        // every T as an object of its own (std::vector<bool> packs bits),
+        // which allows handing out references to and pointers into it.
+        template <typename T>
+        class dist_array_storage
+        {
+        public:
+            dist_array_storage(std::size_t size, T const& init)
+              : size_(size)
+              , data_(new T[size])
+            {
+                std::fill_n(data_.get(), size, init);
+            }
+
+            std::size_t size() const
+            {
+                return size_;
+            }
+
+            T* data() const
+            {
+                return data_.get();
+            }
+
+            T& operator[](std::int64_t offset) const
+            {
+                return data_[offset];
+            }
+
+        private:
+            std::size_t size_;
+            std::unique_ptr<T[]> data_;
+        };
+
+        // Create the local storage of a distributed array on every locale
+        template <typename T, typename Dist>
+        struct dist_array_create
+        {
+            std::shared_ptr<void> operator()(locale const& loc) const
+            {
+                std::int64_t const count = loc.id < dist.num_locales() ?
+                    dist.local(loc.id).size() :
+                    0;
+
+                return std::make_shared<dist_array_storage<T>>(
+                    static_cast<std::size_t>(count), init);
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & dist & init;
+                // clang-format on
+            }
+
+            Dist dist;
+            T init;
+        };
+
+        template <typename T>
+        T dist_array_get(std::uint64_t id, std::int64_t offset)
+        {
+            return get_instance<dist_array_storage<T>>(id)[offset];
+        }
+
+        template <typename T>
+        struct dist_array_get_action
+          : hpx::actions::make_action<decltype(&dist_array_get<T>),
+                &dist_array_get<T>, dist_array_get_action<T>>::type
+        {
+        };
+
+        template <typename T>
+        void dist_array_set(std::uint64_t id, std::int64_t offset, T value)
+        {
+            get_instance<dist_array_storage<T>>(id)[offset] = std::move(value);
+        }
+
+        template <typename T>
+        struct dist_array_set_action
+          : hpx::actions::make_action<decltype(&dist_array_set<T>),
+                &dist_array_set<T>, dist_array_set_action<T>>::type
+        {
+        };
+
+        template <typename T, typename Dist, typename F>
+        struct dist_array_forall
+        {
+            void operator()(locale const& loc) const
+            {
+                if (loc.id >= dist.num_locales())
+                    return;
+
+                local_view<T> const view(dist.local(loc.id),
+                    get_instance<dist_array_storage<T>>(id).data());
+
+                chapel::forall(std::int64_t(0), view.size(),
+                    [&](std::int64_t k) { f(view.index(k), view[k]); });
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & dist & id & f;
+                // clang-format on
+            }
+
+            Dist dist;
+            std::uint64_t id = 0;
+            F f;
+        };
+    }    // namespace detail
+
+    template <typename T, typename Dist>
+    class DistArray
+    {
+    public:
+        // Allocate the elements on all locales, each element is initialized
+        // with `init`
+        explicit DistArray(Dist const& dist, T const& init = T())
+          : dist_(dist)
+          , id_(detail::create_instances(
+                detail::dist_array_create<T, Dist>{dist_, init}))
+        {
+        }
+
+        DistArray(DistArray const&) = delete;
+        DistArray& operator=(DistArray const&) = delete;
+
+        DistArray(DistArray&& rhs) noexcept
+          : dist_(std::move(rhs.dist_))
+          , id_(std::exchange(rhs.id_, 0))
+        {
+        }
+
+        // Releasing the elements of this array communicates with all
+        // locales, which may throw
+        DistArray& operator=(DistArray&& rhs)
+        {
+            if (this != &rhs)
+            {
+                detail::release_instances(id_);
+                dist_ = std::move(rhs.dist_);
+                id_ = std::exchange(rhs.id_, 0);
+            }
+            return *this;
+        }
+
+        ~DistArray()
+        {
+            detail::release_instances(id_, "chapel::DistArray");
+        }
+
+        Dist const& dist() const
+        {
+            return dist_;
+        }
+
+        std::uint64_t id() const
+        {
+            return id_;
+        }
+
+        std::int64_t size() const
+        {
+            return dist_.size();
+        }
+
+        // The elements owned by the calling locale, no data is copied
+        local_view<T> local_slice() const
+        {
+            std::uint32_t const loc = here().id;
+            if (loc >= dist_.num_locales())
+            {
+                return local_view<T>();
+            }
+
+            return local_view<T>(dist_.local(loc),
+                detail::get_instance<detail::dist_array_storage<T>>(id_)
+                    .data());
+        }
+
+        // Read the element at index `idx` (possibly from a remote locale)
+        hpx::future<T> get_async(std::int64_t idx) const
+        {
+            std::uint32_t const owner = dist_.owner(idx);
+            std::int64_t const offset = dist_.local(owner).offset(idx);
+
+            if (owner == here().id)
+            {
+                return hpx::make_ready_future(
+                    detail::dist_array_get<T>(id_, offset));
+            }
+
+            detail::count_comm(detail::comm_op::get);
+            return hpx::async<detail::dist_array_get_action<T>>(
+                hpx::naming::get_id_from_locality_id(owner), id_, offset);
+        }
+
+        T get(std::int64_t idx) const
+        {
+            return get_async(idx).get();
+        }
+
+        // Write the element at index `idx` (possibly on a remote locale)
+        hpx::future<void> set_async(std::int64_t idx, T value)
+        {
+            std::uint32_t const owner = dist_.owner(idx);
+            std::int64_t const offset = dist_.local(owner).offset(idx);
+
+            if (owner == here().id)
+            {
+                detail::dist_array_set<T>(id_, offset, std::move(value));
+                return hpx::make_ready_future();
+            }
+
+            detail::count_comm(detail::comm_op::put);
+            return hpx::async<detail::dist_array_set_action<T>>(
+                hpx::naming::get_id_from_locality_id(owner), id_, offset,
+                std::move(value));
+        }
+
+        void set(std::int64_t idx, T value)
+        {
+            set_async(idx, std::move(value)).get();
+        }
+
+    private:
+        Dist dist_;
+        std::uint64_t id_ = 0;
+    };
+
+    //
+    // Invoke f(i, A[i]) for every index i of the distributed array `A` on the
+    // locale owning the element, the equivalent of
+    //
+    //      forall (i, a) in zip(A.domain, A) do f(i, a);
+    //
+    // Every locale iterates over its local elements using all of its cores,
+    // locales without any elements receive no message. The loop body has to
+    // be serializable.
+    //
+    template <typename T, typename Dist, typename F>
+    void forall(DistArray<T, Dist>& A, F const& f)
+    {
+        coforall_locales(detail::owning_locales(A.dist()),
+            detail::dist_array_forall<T, Dist, F>{A.dist(), A.id(), f});
+    }
+}    // namespace chapel
@@ -0,0 +1,235 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/collectives.hpp>
+#include <hpx/modules/concurrency.hpp>
+
+#include <chapel/coforall_locales.hpp>
+#include <chapel/detail/collectives.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Reductions and scans over distributed index spaces
+//
+// Every locale first combines the values of the indices it owns (using all
+// of its cores, see reduce.hpp), only the per-locale partial results are
+// then exchanged between the locales using HPX collective operations. The
+// reduction operator and the functions passed have to be serializable.
+
+namespace chapel {
+
+    namespace detail {
+
+        template <typename Dist, typename Op, typename F>
+        struct dist_reduce
+        {
+            using result_type = reduce_result_t<Op>;
+
+            void operator()(locale const& loc) const
+            {
+                result_type partial = op.identity();
+                if (loc.id < dist.num_locales())
+                {
+                    local_indices const local = dist.local(loc.id);
+                    partial = chapel::reduce(0, local.size(), op,
+                        [&](std::int64_t k) { return f(local[k]); });
+                }
+
+                if (numLocales() > 1)
+                {
+                    count_comm(comm_op::execute_on);
+                }
+
+                result_type value =
+                    hpx::collectives::all_reduce(get_locales_communicator(),
+                        std::move(partial), op,
+                        hpx::collectives::this_site_arg(loc.id),
+                        hpx::collectives::generation_arg(generation))
+                        .get();
+
+                // only the initiating locale holds a result
+                if (result)
+                {
+                    *result = std::move(value);
+                }
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & dist & op & f & generation;
+                // clang-format on
+            }
+
+            Dist dist;
+            Op op;
+            F f;
+            std::size_t generation = 0;
+            std::shared_ptr<result_type> result;
+        };
+
+        template <typename Dist, typename Op, typename F, typename G>
+        struct dist_scan
+        {
+            using result_type = reduce_result_t<Op>;
+
+            void operator()(locale const& loc) const
+            {
+                local_indices local;
+                if (loc.id < dist.num_locales())
+                {
+                    local = dist.local(loc.id);
+                }
+
+                // first pass: reduce the chunk of each task
+                std::size_t const num_tasks = forall_num_tasks(local.size());
+                std::vector<hpx::util::cache_aligned_data<result_type>>
+                    partials(num_tasks);
+
+                forall_tasks(0, local.size(), num_tasks,
+                    [&](std::size_t task, std::int64_t lo, std::int64_t hi) {
+                        result_type acc = op.identity();
+                        for (std::int64_t k = lo; k != hi; ++k)
+                        {
+                            acc = op(acc, f(local[k]));
+                        }
+                        partials[task].data_ = std::move(acc);
+                    });
+
+                // turn the partial results into exclusive prefixes
+                result_type total = op.identity();
+                for (auto& partial : partials)
+                {
+                    result_type next = op(total, partial.data_);
+                    partial.data_ = std::move(total);
+                    total = std::move(next);
+                }
+
+                // exchange the totals of all locales, the blocks owned by the
+                // locales preceding this one precede its own block
+                if (numLocales() > 1)
+                {
+                    count_comm(comm_op::execute_on);
+                }
+
+                std::vector<result_type> totals =
+                    hpx::collectives::all_gather(get_locales_communicator(),
+                        std::move(total),
+                        hpx::collectives::this_site_arg(loc.id),
+                        hpx::collectives::generation_arg(generation))
+                        .get();
+
+                result_type prefix = op.identity();
+                for (std::uint32_t l = 0; l != loc.id; ++l)
+                {
+                    prefix = op(prefix, totals[l]);
+                }
+
+                // second pass: compute the scan of the chunk of each task
+                forall_tasks(0, local.size(), num_tasks,
+                    [&](std::size_t task, std::int64_t lo, std::int64_t hi) {
+                        result_type acc = op(prefix, partials[task].data_);
+                        for (std::int64_t k = lo; k != hi; ++k)
+                        {
+                            std::int64_t const idx = local[k];
+                            if (inclusive)
+                            {
+                                acc = op(acc, f(idx));
+                                g(idx, acc);
+                            }
+                            else
+                            {
+                                g(idx, acc);
+                                acc = op(acc, f(idx));
+                            }
+                        }
+                    });
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & dist & op & f & g & generation & inclusive;
+                // clang-format on
+            }
+
+            Dist dist;
+            Op op;
+            F f;
+            G g;
+            std::size_t generation = 0;
+            bool inclusive = true;
+        };
+    }    // namespace detail
+
+    //
+    // Reduce the values f(i) for all indices i of the distributed index space
+    // `dist` using `op`, the equivalent of
+    //
+    //      op reduce [i in D] f(i)
+    //
+    // Each locale reduces the values of the indices it owns, the partial
+    // results are then combined using an all_reduce across all locales. As
+    // the indices owned by a locale need not be consecutive, and the partial
+    // results are combined in no particular order, `op` has to be
+    // commutative.
+    //
+    template <typename Dist, typename Op, typename F>
+    reduce_result_t<Op> reduce(Dist const& dist, Op const& op, F const& f)
+    {
+        using result_type = reduce_result_t<Op>;
+
+        auto result = std::make_shared<result_type>(op.identity());
+        coforall_locales(detail::dist_reduce<Dist, Op, F>{
+            dist, op, f, detail::next_collective_generation(), result});
+
+        return std::move(*result);
+    }
+
+    //
+    // Compute the inclusive scan of the values f(i) in index order over the
+    // distributed index space `dist` using `op`, and invoke g(i, scan(i)) on
+    // the locale owning index i. This is the equivalent of
+    //
+    //      forall (i, s) in zip(D, op scan [i in D] f(i)) do g(i, s);
+    //
+    // The scan requires that the locales own consecutive blocks of indices
+    // in locale order, i.e. a `Block` distribution. The function `f` is
+    // invoked twice for every index.
+    //
+    template <typename Op, typename F, typename G>
+    void inclusive_scan(Block const& dist, Op const& op, F const& f, G const& g)
+    {
+        coforall_locales(detail::dist_scan<Block, Op, F, G>{
+            dist, op, f, g, detail::next_collective_generation(), true});
+    }
+
+    //
+    // Same as inclusive_scan(), except that g(i, s) receives the combination
+    // of the values f(j) of all indices j preceding i (but not f(i) itself).
+    // The first index receives the identity of `op`.
+    //
+    template <typename Op, typename F, typename G>
+    void exclusive_scan(Block const& dist, Op const& op, F const& f, G const& g)
+    {
+        coforall_locales(detail::dist_scan<Block, Op, F, G>{
+            dist, op, f, g, detail::next_collective_generation(), false});
+    }
+}    // namespace chapel
@@ -0,0 +1,394 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/assert.hpp>
+#include <hpx/modules/serialization.hpp>
+
+#include <chapel/locales.hpp>
+#include <chapel/range.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Standard Chapel distributions (`CyclicDist`, `BlockDist`, `BlockCycDist`)
+//
+// A distribution maps each index of a one-dimensional index space
+// [first, last) (or of an unstrided range) to the locale owning it. All
+// mappings are purely arithmetic, so every locality can compute which indices
+// it owns from the (small) distribution descriptor alone, without any
+// communication.
+
+namespace chapel {
+
+    namespace detail {
+
+        // Division and modulo rounding towards negative infinity, needed as
+        // the indices of a distribution may precede its `startIdx`.
+        constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b)
+        {
+            return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+        }
+
+        constexpr std::int64_t floor_mod(std::int64_t a, std::int64_t b)
+        {
+            return a - floor_div(a, b) * b;
+        }
+    }    // namespace detail
+
+    //
+    // The set of indices owned by one locale. All standard distributions
+    // assign indices to locales in blocks of `block` consecutive indices that
+    // repeat every `stride` indices starting at `base`, clipped to the bounds
+    // of the distributed index space. The local indices are numbered densely
+    // starting at zero, which makes the set random-access and allows for it to
+    // be partitioned arbitrarily between the tasks of a locale.
+    //
+    class local_indices
+    {
+    public:
+        constexpr local_indices() = default;
+
+        // Create the set of indices matching the pattern described by `base`,
+        // `block`, and `stride` that fall into [first, last).
+        constexpr local_indices(std::int64_t first, std::int64_t last,
+            std::int64_t base, std::int64_t block, std::int64_t stride)
+          : base_(base)
+          , block_(block)
+          , stride_(stride)
+          , skip_(pattern_count(first))
+          , count_(pattern_count(last) - skip_)
+        {
+        }
+
+        constexpr std::int64_t size() const
+        {
+            return count_;
+        }
+
+        constexpr bool empty() const
+        {
+            return count_ == 0;
+        }
+
+        // Return the k'th index owned by the locale, 0 <= k < size()
+        constexpr std::int64_t operator[](std::int64_t k) const
+        {
+            k += skip_;
+            return base_ + (k / block_) * stride_ + k % block_;
+        }
+
+        // Return the position of the locally owned index `idx`, this is the
+        // inverse of operator[]
+        constexpr std::int64_t offset(std::int64_t idx) const
+        {
+            return pattern_count(idx) - skip_;
+        }
+
+        template <typename F>
+        void for_each(F&& f) const
+        {
+            for (std::int64_t k = 0; k != count_; ++k)
+            {
+                f((*this)[k]);
+            }
+        }
+
+    private:
+        // number of pattern elements in [base, idx)
+        constexpr std::int64_t pattern_count(std::int64_t idx) const
+        {
+            if (idx <= base_)
+                return 0;
+
+            std::int64_t const d = idx - base_;
+            return (d / stride_) * block_ + (std::min)(d % stride_, block_);
+        }
+
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & base_ & block_ & stride_ & skip_ & count_;
+            // clang-format on
+        }
+
+        std::int64_t base_ = 0;
+        std::int64_t block_ = 1;
+        std::int64_t stride_ = 1;
+        std::int64_t skip_ = 0;
+        std::int64_t count_ = 0;
+    };
+
+    //
+    // The `Cyclic` distribution maps indices to locales in a round-robin
+    // fashion where `startIdx` is mapped to locale #0.
+    //
+    class Cyclic
+    {
+    public:
+        Cyclic() = default;
+
+        Cyclic(std::int64_t first, std::int64_t last, std::int64_t startIdx,
+            std::uint32_t num_locales = numLocales())
+          : first_(first)
+          , last_((std::max)(first, last))
+          , startIdx_(startIdx)
+          , num_locales_(num_locales)
+        {
+        }
+
+        // distribute the indices of the (unstrided) range `r`
+        Cyclic(range const& r, std::int64_t startIdx,
+            std::uint32_t num_locales = numLocales())
+          : Cyclic(r.empty() ? 0 : r.low(), r.empty() ? 0 : r.high() + 1,
+                startIdx, num_locales)
+        {
+            HPX_ASSERT(r.stride() == 1);
+        }
+
+        std::int64_t first() const
+        {
+            return first_;
+        }
+        std::int64_t last() const
+        {
+            return last_;
+        }
+        std::int64_t size() const
+        {
+            return last_ - first_;
+        }
+        std::uint32_t num_locales() const
+        {
+            return num_locales_;
+        }
+
+        std::uint32_t owner(std::int64_t idx) const
+        {
+            return static_cast<std::uint32_t>(
+                detail::floor_mod(idx - startIdx_, num_locales_));
+        }
+
+        local_indices local(std::uint32_t locale) const
+        {
+            return local_indices(first_, last_,
+                first_ +
+                    detail::floor_mod(
+                        std::int64_t(locale) - owner(first_), num_locales_),
+                1, num_locales_);
+        }
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & first_ & last_ & startIdx_ & num_locales_;
+            // clang-format on
+        }
+
+        std::int64_t first_ = 0;
+        std::int64_t last_ = 0;
+        std::int64_t startIdx_ = 0;
+        std::uint32_t num_locales_ = 1;
+    };
+
+    //
+    // The `Block` distribution maps a contiguous block of indices to each
+    // locale. The blocks are balanced such that their sizes differ by at most
+    // one index.
+    //
+    class Block
+    {
+    public:
+        Block() = default;
+
+        Block(std::int64_t first, std::int64_t last,
+            std::uint32_t num_locales = numLocales())
+          : first_(first)
+          , last_((std::max)(first, last))
+          , num_locales_(num_locales)
+        {
+        }
+
+        Block(range const& r, std::uint32_t num_locales = numLocales())
+          : Block(r.empty() ? 0 : r.low(), r.empty() ? 0 : r.high() + 1,
+                num_locales)
+        {
+            HPX_ASSERT(r.stride() == 1);
+        }
+
+        std::int64_t first() const
+        {
+            return first_;
+        }
+        std::int64_t last() const
+        {
+            return last_;
+        }
+        std::int64_t size() const
+        {
+            return last_ - first_;
+        }
+        std::uint32_t num_locales() const
+        {
+            return num_locales_;
+        }
+
+        // locale L owns [bound(L), bound(L + 1))
+        std::int64_t bound(std::uint32_t locale) const
+        {
+            return first_ + (locale * size()) / num_locales_;
+        }
+
+        std::uint32_t owner(std::int64_t idx) const
+        {
+            return static_cast<std::uint32_t>(
+                ((idx - first_ + 1) * num_locales_ - 1) / size());
+        }
+
+        local_indices local(std::uint32_t locale) const
+        {
+            std::int64_t const lo = bound(locale);
+            std::int64_t const hi = bound(locale + 1);
+            return local_indices(
+                lo, hi, lo, hi - lo, (std::max)(hi - lo, std::int64_t(1)));
+        }
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & first_ & last_ & num_locales_;
+            // clang-format on
+        }
+
+        std::int64_t first_ = 0;
+        std::int64_t last_ = 0;
+        std::uint32_t num_locales_ = 1;
+    };
+
+    //
+    // The `BlockCyclic` distribution deals out blocks of `blocksize`
+    // consecutive indices to the locales in a round-robin fashion where the
+    // block starting at `startIdx` is mapped to locale #0.
+    //
+    class BlockCyclic
+    {
+    public:
+        BlockCyclic() = default;
+
+        BlockCyclic(std::int64_t first, std::int64_t last,
+            std::int64_t startIdx, std::int64_t blocksize,
+            std::uint32_t num_locales = numLocales())
+          : first_(first)
+          , last_((std::max)(first, last))
+          , startIdx_(startIdx)
+          , blocksize_((std::max)(blocksize, std::int64_t(1)))
+          , num_locales_(num_locales)
+        {
+        }
+
+        BlockCyclic(range const& r, std::int64_t startIdx,
+            std::int64_t blocksize, std::uint32_t num_locales = numLocales())
+          : BlockCyclic(r.empty() ? 0 : r.low(), r.empty() ? 0 : r.high() + 1,
+                startIdx, blocksize, num_locales)
+        {
+            HPX_ASSERT(r.stride() == 1);
+        }
+
+        std::int64_t first() const
+        {
+            return first_;
+        }
+        std::int64_t last() const
+        {
+            return last_;
+        }
+        std::int64_t size() const
+        {
+            return last_ - first_;
+        }
+        std::uint32_t num_locales() const
+        {
+            return num_locales_;
+        }
+        std::int64_t blocksize() const
+        {
+            return blocksize_;
+        }
+
+        std::uint32_t owner(std::int64_t idx) const
+        {
+            return static_cast<std::uint32_t>(detail::floor_mod(
+                detail::floor_div(idx - startIdx_, blocksize_), num_locales_));
+        }
+
+        local_indices local(std::uint32_t locale) const
+        {
+            // the first block owned by `locale` that is not entirely before
+            // `first`
+            std::int64_t const b0 =
+                detail::floor_div(first_ - startIdx_, blocksize_);
+            std::int64_t const b =
+                b0 + detail::floor_mod(locale - b0, num_locales_);
+
+            return local_indices(first_, last_, startIdx_ + b * blocksize_,
+                blocksize_, blocksize_ * num_locales_);
+        }
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & first_ & last_ & startIdx_ & blocksize_ & num_locales_;
+            // clang-format on
+        }
+
+        std::int64_t first_ = 0;
+        std::int64_t last_ = 0;
+        std::int64_t startIdx_ = 0;
+        std::int64_t blocksize_ = 1;
+        std::uint32_t num_locales_ = 1;
+    };
+
+    namespace detail {
+
+        // The locales owning at least one index of `dist`, e.g. a Block
+        // distribution of fewer indices than locales leaves some locales
+        // without any
+        template <typename Dist>
+        std::vector<std::uint32_t> owning_locales(Dist const& dist)
+        {
+            std::uint32_t const count =
+                (std::min)(dist.num_locales(), numLocales());
+
+            std::vector<std::uint32_t> locales;
+            locales.reserve(count);
+            for (std::uint32_t loc = 0; loc != count; ++loc)
+            {
+                if (!dist.local(loc).empty())
+                {
+                    locales.push_back(loc);
+                }
+            }
+            return locales;
+        }
+    }    // namespace detail
+}    // namespace chapel
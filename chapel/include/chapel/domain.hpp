@@ -0,0 +1,192 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/serialization.hpp>
+
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/range.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+// Chapel's rectangular domains
+//
+// A `domain<N>` is the cross product of `N` (possibly strided) ranges:
+//
+//      const D = {1..n, 1..m by 2};
+//
+// is written as
+//
+//      chapel::domain const D(chapel::range(1, n), chapel::range(1, m).by(2));
+//
+// A forall-loop over a multidimensional domain splits the domain into tiles
+// and deals out contiguous sequences of tiles (in row-major order) to the
+// tasks. Every tile is traversed in row-major order, which keeps the
+// working set of neighbouring iterations (e.g. of a stencil) in cache.
+
+namespace chapel {
+
+    template <std::size_t N>
+    class domain
+    {
+        static_assert(N != 0, "a domain has at least one dimension");
+
+    public:
+        domain() = default;
+
+        template <typename... Ranges,
+            typename Enable = std::enable_if_t<sizeof...(Ranges) == N &&
+                (std::is_convertible_v<Ranges const&, range> && ...)>>
+        explicit domain(Ranges const&... dims)
+          : dims_{range(dims)...}
+        {
+        }
+
+        static constexpr std::size_t rank()
+        {
+            return N;
+        }
+
+        range const& dim(std::size_t d) const
+        {
+            return dims_[d];
+        }
+
+        // number of indices in the domain
+        std::int64_t size() const
+        {
+            std::int64_t size = 1;
+            for (range const& r : dims_)
+            {
+                size *= r.size();
+            }
+            return size;
+        }
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & dims_;
+            // clang-format on
+        }
+
+        std::array<range, N> dims_;
+    };
+
+    template <typename... Ranges>
+    domain(Ranges const&...) -> domain<sizeof...(Ranges)>;
+
+    namespace detail {
+
+        // Default extent of the tiles along each dimension
+        inline constexpr std::int64_t domain_tile_size = 64;
+
+        // Invoke f(i, j, ...) for all indices of the tile spanning the
+        // positions [lo[d], hi[d]) along each dimension d of `D`
+        template <std::size_t Dim, std::size_t N, typename F>
+        void forall_tile(domain<N> const& D,
+            std::array<std::int64_t, N> const& lo,
+            std::array<std::int64_t, N> const& hi,
+            std::array<std::int64_t, N>& idx, F const& f)
+        {
+            range const& r = D.dim(Dim);
+            for (std::int64_t k = lo[Dim]; k != hi[Dim]; ++k)
+            {
+                idx[Dim] = r[k];
+                if constexpr (Dim + 1 == N)
+                {
+                    std::apply(f, idx);
+                }
+                else
+                {
+                    forall_tile<Dim + 1>(D, lo, hi, idx, f);
+                }
+            }
+        }
+
+        // Split `D` into tiles of tile[d] indices along each dimension d and
+        // invoke g(lo, hi) for every tile, where the tile spans the positions
+        // [lo[d], hi[d]) along dimension d. Contiguous sequences of tiles (in
+        // row-major order) are dealt out to the tasks.
+        template <std::size_t N, typename G>
+        void forall_tiles(domain<N> const& D,
+            std::array<std::int64_t, N> const& tile, G const& g)
+        {
+            // number of tiles along each dimension and overall
+            std::array<std::int64_t, N> extent;
+            std::array<std::int64_t, N> tiles;
+            std::int64_t num_tiles = 1;
+            for (std::size_t d = 0; d != N; ++d)
+            {
+                extent[d] = (std::max)(tile[d], std::int64_t(1));
+                tiles[d] = (D.dim(d).size() + extent[d] - 1) / extent[d];
+                num_tiles *= tiles[d];
+            }
+
+            std::size_t const num_tasks = (std::min)(
+                forall_num_tasks(D.size()), std::size_t(num_tiles));
+
+            forall_tasks(0, num_tiles, num_tasks,
+                [&](std::size_t, std::int64_t first, std::int64_t last) {
+                    std::array<std::int64_t, N> lo, hi;
+                    for (std::int64_t t = first; t != last; ++t)
+                    {
+                        // position of the tile, row-major
+                        std::int64_t rest = t;
+                        for (std::size_t d = N; d-- != 0;)
+                        {
+                            lo[d] = (rest % tiles[d]) * extent[d];
+                            hi[d] =
+                                (std::min)(lo[d] + extent[d], D.dim(d).size());
+                            rest /= tiles[d];
+                        }
+
+                        g(lo, hi);
+                    }
+                });
+        }
+    }    // namespace detail
+
+    //
+    // Invoke f(i, j, ...) for all indices (i, j, ...) of the domain `D`, the
+    // equivalent of
+    //
+    //      forall (i, j, ...) in D do f(i, j, ...);
+    //
+    // The domain is traversed in tiles of tile[d] indices along each
+    // dimension d.
+    //
+    template <std::size_t N, typename F>
+    void forall(domain<N> const& D, std::array<std::int64_t, N> const& tile,
+        F const& f)
+    {
+        detail::forall_tiles(D, tile,
+            [&](std::array<std::int64_t, N> const& lo,
+                std::array<std::int64_t, N> const& hi) {
+                std::array<std::int64_t, N> idx;
+                detail::forall_tile<0>(D, lo, hi, idx, f);
+            });
+    }
+
+    template <std::size_t N, typename F>
+    void forall(domain<N> const& D, F const& f)
+    {
+        std::array<std::int64_t, N> tile;
+        tile.fill(detail::domain_tile_size);
+
+        forall(D, tile, f);
+    }
+}    // namespace chapel
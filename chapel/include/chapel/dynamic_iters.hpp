@@ -0,0 +1,280 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/concurrency.hpp>
+#include <hpx/modules/synchronization.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/detail/loop_trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Chapel's `DynamicIters` module
+//
+// By default, a forall-loop assigns every task a fixed chunk of iterations,
+// which leaves cores idle if the cost of the iterations varies. The
+// iterators below distribute the iterations dynamically instead:
+//
+//      forall i in dynamic(first..last-1, chunkSize) do f(i);
+//
+// is written as
+//
+//      chapel::forall(chapel::dynamic(first, last, chunkSize), f);
+//
+// If `numTasks` is zero, the number of tasks is chosen as for any other
+// forall-loop. The loops are traced as forall-loops (see loop_trace.hpp),
+// with every chunk of iterations claimed by a task recorded as a task.
+
+namespace chapel {
+
+    struct dynamic_iter
+    {
+        std::int64_t first;
+        std::int64_t last;
+        std::int64_t chunkSize;
+        std::size_t numTasks;
+    };
+
+    struct guided_iter
+    {
+        std::int64_t first;
+        std::int64_t last;
+        std::size_t numTasks;
+    };
+
+    struct adaptive_iter
+    {
+        std::int64_t first;
+        std::int64_t last;
+        std::size_t numTasks;
+    };
+
+    //
+    // The iterations are handed out in chunks of `chunkSize` iterations to
+    // whichever task asks for work next.
+    //
+    inline dynamic_iter dynamic(std::int64_t first, std::int64_t last,
+        std::int64_t chunkSize = 1, std::size_t numTasks = 0)
+    {
+        return dynamic_iter{
+            first, last, (std::max)(chunkSize, std::int64_t(1)), numTasks};
+    }
+
+    //
+    // The iterations are handed out in chunks whose size is proportional to
+    // the number of remaining iterations divided by the number of tasks.
+    //
+    inline guided_iter guided(
+        std::int64_t first, std::int64_t last, std::size_t numTasks = 0)
+    {
+        return guided_iter{first, last, numTasks};
+    }
+
+    //
+    // The iterations are split evenly between the tasks. Every task works
+    // through its own sub-range in decreasing chunks and, once it runs out
+    // of work, steals half of the remaining iterations from another task.
+    //
+    inline adaptive_iter adaptive(
+        std::int64_t first, std::int64_t last, std::size_t numTasks = 0)
+    {
+        return adaptive_iter{first, last, numTasks};
+    }
+
+    namespace detail {
+
+        inline std::size_t dynamic_num_tasks(
+            std::int64_t count, std::size_t numTasks)
+        {
+            if (numTasks == 0 || count <= 0)
+                return forall_num_tasks(count);
+
+            return (std::min)(static_cast<std::size_t>(count), numTasks);
+        }
+
+        struct adaptive_range
+        {
+            hpx::spinlock mtx;
+            std::int64_t lo = 0;
+            std::int64_t hi = 0;
+        };
+
+        using adaptive_ranges =
+            std::vector<hpx::util::cache_aligned_data<adaptive_range>>;
+
+        // Take the next chunk from the front of the task's own range
+        inline bool adaptive_next(adaptive_range& r, std::size_t num_tasks,
+            std::int64_t& lo, std::int64_t& hi)
+        {
+            std::lock_guard<hpx::spinlock> l(r.mtx);
+
+            std::int64_t const remaining = r.hi - r.lo;
+            if (remaining <= 0)
+                return false;
+
+            std::int64_t const chunk = (std::max)(std::int64_t(1),
+                remaining / static_cast<std::int64_t>(2 * num_tasks));
+
+            lo = r.lo;
+            hi = r.lo + chunk;
+            r.lo = hi;
+            return true;
+        }
+
+        // Move the upper half of the range of some other task to the range
+        // of task `self`
+        inline bool adaptive_steal(adaptive_ranges& ranges, std::size_t self)
+        {
+            std::size_t const num_tasks = ranges.size();
+            for (std::size_t i = 1; i != num_tasks; ++i)
+            {
+                adaptive_range& victim = ranges[(self + i) % num_tasks].data_;
+
+                std::int64_t lo, hi;
+                {
+                    std::lock_guard<hpx::spinlock> l(victim.mtx);
+
+                    std::int64_t const remaining = victim.hi - victim.lo;
+                    if (remaining <= 0)
+                        continue;
+
+                    lo = victim.lo + remaining / 2;
+                    hi = victim.hi;
+                    victim.hi = lo;
+                }
+
+                adaptive_range& r = ranges[self].data_;
+                std::lock_guard<hpx::spinlock> l(r.mtx);
+                r.lo = lo;
+                r.hi = hi;
+                return true;
+            }
+            return false;
+        }
+
+        // Run body(task, trace) as `num_tasks` tasks of a forall-loop over
+        // `count` iterations
+        template <typename F>
+        void dynamic_tasks(std::int64_t count, std::size_t num_tasks, F&& body)
+        {
+            loop_trace trace(loop_kind::forall,
+                (std::max)(count, std::int64_t(0)), num_tasks);
+
+            spawn_tasks(
+                hpx::threads::thread_stacksize::default_, 0,
+                static_cast<std::int64_t>(num_tasks),
+                [](std::int64_t) {
+                    return hpx::threads::thread_schedule_hint();
+                },
+                [&](std::int64_t task) { body(task, trace); });
+        }
+
+        // Execute the iterations [lo, hi) claimed by a task, every chunk is
+        // traced as a task of the loop
+        template <typename F>
+        void dynamic_chunk(
+            loop_trace& trace, std::int64_t lo, std::int64_t hi, F const& f)
+        {
+            loop_trace::task_timer timer(trace, hi - lo);
+            for (std::int64_t i = lo; i != hi; ++i)
+            {
+                f(i);
+            }
+        }
+    }    // namespace detail
+
+    template <typename F>
+    void forall(dynamic_iter const& iter, F const& f)
+    {
+        std::int64_t const count = iter.last - iter.first;
+        std::size_t const num_tasks =
+            detail::dynamic_num_tasks(count, iter.numTasks);
+
+        std::atomic<std::int64_t> next(iter.first);
+
+        detail::dynamic_tasks(count, num_tasks,
+            [&](std::int64_t, detail::loop_trace& trace) {
+                while (true)
+                {
+                    std::int64_t const lo = next.fetch_add(iter.chunkSize);
+                    if (lo >= iter.last)
+                        break;
+
+                    std::int64_t const hi =
+                        (std::min)(lo + iter.chunkSize, iter.last);
+                    detail::dynamic_chunk(trace, lo, hi, f);
+                }
+            });
+    }
+
+    template <typename F>
+    void forall(guided_iter const& iter, F const& f)
+    {
+        std::int64_t const count = iter.last - iter.first;
+        std::size_t const num_tasks =
+            detail::dynamic_num_tasks(count, iter.numTasks);
+
+        std::atomic<std::int64_t> next(iter.first);
+
+        detail::dynamic_tasks(count, num_tasks,
+            [&](std::int64_t, detail::loop_trace& trace) {
+                std::int64_t lo = next.load(std::memory_order_relaxed);
+                while (lo < iter.last)
+                {
+                    std::int64_t const chunk = (std::max)(std::int64_t(1),
+                        (iter.last - lo) /
+                            static_cast<std::int64_t>(num_tasks));
+
+                    if (!next.compare_exchange_weak(lo, lo + chunk))
+                        continue;    // `lo` has been reloaded
+
+                    detail::dynamic_chunk(trace, lo, lo + chunk, f);
+                    lo = next.load(std::memory_order_relaxed);
+                }
+            });
+    }
+
+    template <typename F>
+    void forall(adaptive_iter const& iter, F const& f)
+    {
+        std::int64_t const count = iter.last - iter.first;
+        std::size_t const num_tasks =
+            detail::dynamic_num_tasks(count, iter.numTasks);
+        auto const tasks = static_cast<std::int64_t>(num_tasks);
+
+        // all ranges have to be initialized before any task may steal
+        detail::adaptive_ranges ranges(num_tasks);
+        for (std::int64_t task = 0; task != tasks; ++task)
+        {
+            ranges[task].data_.lo = iter.first + task * count / tasks;
+            ranges[task].data_.hi = iter.first + (task + 1) * count / tasks;
+        }
+
+        detail::dynamic_tasks(count, num_tasks,
+            [&](std::int64_t task, detail::loop_trace& trace) {
+                auto const self = static_cast<std::size_t>(task);
+                detail::adaptive_range& r = ranges[self].data_;
+
+                do
+                {
+                    std::int64_t lo, hi;
+                    while (detail::adaptive_next(r, num_tasks, lo, hi))
+                    {
+                        detail::dynamic_chunk(trace, lo, hi, f);
+                    }
+                } while (detail::adaptive_steal(ranges, self));
+            });
+    }
+}    // namespace chapel
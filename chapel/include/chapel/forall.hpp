@@ -0,0 +1,89 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chapel/coforall_locales.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/locales.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chapel {
+
+    //
+    // Invoke f(i) for all i in [first, last), the equivalent of
+    //
+    //      forall i in first..last-1 do f(i);
+    //
+    // The iterations are split into contiguous chunks, one per task. The
+    // number of tasks is determined by dataParTasksPerLocale,
+    // dataParIgnoreRunningTasks, and dataParMinGranularity (see config.hpp),
+    // loops that are too small to benefit from running in parallel are
+    // executed serially by the calling task.
+    //
+    template <typename F>
+    void forall(std::int64_t first, std::int64_t last, F const& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        detail::forall_tasks(first, last, num_tasks,
+            [&](std::size_t, std::int64_t lo, std::int64_t hi) {
+                for (std::int64_t i = lo; i != hi; ++i)
+                {
+                    f(i);
+                }
+            });
+    }
+
+    namespace detail {
+
+        // Execute the iterations of a distributed forall-loop that are owned
+        // by the current locale using all of its processing units.
+        template <typename Dist, typename F>
+        struct forall_local
+        {
+            void operator()(locale const& loc) const
+            {
+                if (loc.id >= dist.num_locales())
+                    return;
+
+                local_indices const local = dist.local(loc.id);
+                chapel::forall(std::int64_t(0), local.size(),
+                    [&](std::int64_t k) { f(local[k]); });
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & dist & f;
+                // clang-format on
+            }
+
+            Dist dist;
+            F f;
+        };
+    }    // namespace detail
+
+    //
+    // A forall-loop driven by a distributed index space executes each
+    // iteration on the locale which owns that index. Every locale receives a
+    // single message carrying the distribution descriptor and the loop body
+    // (through the spawn tree used by coforall_locales()) and derives its own
+    // indices from it, thus the number of messages sent does not depend on
+    // the number of iterations. Locales that don't own any index are not
+    // part of the spawn tree and receive no message. The loop body has to be
+    // serializable.
+    //
+    template <typename Dist, typename F>
+    void forall(Dist const& dist, F const& f)
+    {
+        coforall_locales(detail::owning_locales(dist),
+            detail::forall_local<Dist, F>{dist, f});
+    }
+}    // namespace chapel
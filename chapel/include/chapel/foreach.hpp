@@ -0,0 +1,107 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/config.hpp>
+#include <hpx/modules/algorithms.hpp>
+#include <hpx/modules/execution.hpp>
+
+#if defined(HPX_HAVE_DATAPAR)
+#include <hpx/datapar.hpp>
+#endif
+
+#include <chapel/detail/forall_tasks.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Chapel's `foreach` loop
+//
+// A foreach-loop asserts that its iterations are order-independent, but
+// (unlike a forall-loop) does not create any tasks. It is executed by the
+// calling task using HPX's unsequenced (or, if HPX was configured with
+// HPX_WITH_DATAPAR, its simd) execution policy, which allows the compiler to
+// vectorize the loop body. Combined with a forall-loop (forall_simd()),
+// every task vectorizes the chunk of iterations it executes, the equivalent
+// of HPX's par_simd execution policy.
+
+namespace chapel {
+
+    namespace detail {
+
+#if defined(HPX_HAVE_DATAPAR)
+        inline auto foreach_policy()
+        {
+            return hpx::execution::simd;
+        }
+#else
+        inline auto foreach_policy()
+        {
+            return hpx::execution::unseq;
+        }
+#endif
+    }    // namespace detail
+
+    //
+    // Invoke f(i) for all i in [first, last), the equivalent of
+    //
+    //      foreach i in first..last-1 do f(i);
+    //
+    template <typename F>
+    void foreach(std::int64_t first, std::int64_t last, F&& f)
+    {
+        hpx::experimental::for_loop(hpx::execution::unseq, first, last, f);
+    }
+
+    //
+    // Invoke f(a) for all elements a in the contiguous sequence [first,
+    // last), the equivalent of
+    //
+    //      foreach a in A do f(a);
+    //
+    // If HPX supports explicit vectorization, `f` is invoked with a SIMD
+    // pack (hpx::experimental::native_simd<T>) holding consecutive elements
+    // for most of the sequence and with scalar packs for the remaining
+    // elements. Modifications of the pack are stored back to the sequence.
+    // Thus the body has to be generic, e.g.
+    //
+    //      chapel::foreach(a, a + n, [](auto& v) { v = 2 * v + 1; });
+    //
+    template <typename T, typename F>
+    void foreach(T* first, T* last, F&& f)
+    {
+        hpx::for_each(detail::foreach_policy(), first, last, f);
+    }
+
+    //
+    // A forall-loop whose tasks execute their chunk of iterations as a
+    // foreach-loop, i.e. the equivalent of
+    //
+    //      forall i in first..last-1 do foreach j in chunk(i) do f(j);
+    //
+    // The iterations are divided between the tasks as for chapel::forall().
+    //
+    template <typename F>
+    void forall_simd(std::int64_t first, std::int64_t last, F const& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        detail::forall_tasks(first, last, num_tasks,
+            [&](std::size_t, std::int64_t lo, std::int64_t hi) {
+                foreach(lo, hi, f);
+            });
+    }
+
+    template <typename T, typename F>
+    void forall_simd(T* first, T* last, F const& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        detail::forall_tasks(0, last - first, num_tasks,
+            [&](std::size_t, std::int64_t lo, std::int64_t hi) {
+                foreach(first + lo, first + hi, f);
+            });
+    }
+}    // namespace chapel
@@ -0,0 +1,347 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/concurrency.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/coforall_locales.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/range.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Task intents (``with (in x, ref y, const ref z, + reduce s)``)
+//
+//      forall i in 1..n with (in x, ref y, + reduce s) do f(i, x, y, s);
+//
+// is written as
+//
+//      chapel::forall(chapel::range(1, n),
+//          chapel::with(chapel::in(x), chapel::ref(y),
+//              chapel::with_reduce(s, chapel::sum_op<int>())),
+//          f);
+//
+// The loop body receives one argument per intent after the loop index:
+//
+//  - in:        a copy of the variable that is private to the task, i.e. it
+//               is copied once per task (not once per iteration) and lives
+//               on the stack of the task, so no two tasks share a cache line
+//  - ref:       a reference to the (shared) variable itself
+//  - const_ref: a const reference to the variable itself
+//  - reduce:    the private accumulator of the task (see reduce.hpp)
+//
+// Only `in` intents can be used with coforall_locales(), their values are
+// serialized once per locale and then passed (by reference) to the body.
+
+namespace chapel {
+
+    template <typename T>
+    struct in_intent
+    {
+        T value;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & value;
+            // clang-format on
+        }
+    };
+
+    template <typename T>
+    struct ref_intent
+    {
+        T& var;
+    };
+
+    template <typename T>
+    struct const_ref_intent
+    {
+        T const& var;
+    };
+
+    template <typename T>
+    in_intent<std::decay_t<T>> in(T&& value)
+    {
+        return in_intent<std::decay_t<T>>{std::forward<T>(value)};
+    }
+
+    template <typename T>
+    ref_intent<T> ref(T& var)
+    {
+        return ref_intent<T>{var};
+    }
+
+    template <typename T>
+    const_ref_intent<T> const_ref(T const& var)
+    {
+        return const_ref_intent<T>{var};
+    }
+
+    template <typename... Intents>
+    struct with_clause
+    {
+        std::tuple<Intents...> intents;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & intents;
+            // clang-format on
+        }
+    };
+
+    template <typename... Intents>
+    with_clause<Intents...> with(Intents... intents)
+    {
+        return with_clause<Intents...>{
+            std::tuple<Intents...>(std::move(intents)...)};
+    }
+
+    namespace detail {
+
+        // The state of an intent for the duration of a loop. task_state()
+        // creates what is passed to the loop body of a task, task_done()
+        // is invoked once the task has finished, and finish() once all
+        // tasks have finished.
+        template <typename Intent>
+        class intent_state;
+
+        template <typename T>
+        class intent_state<in_intent<T>>
+        {
+        public:
+            intent_state(in_intent<T> const& intent, std::size_t)
+              : intent_(intent)
+            {
+            }
+
+            T task_state() const
+            {
+                return intent_.value;
+            }
+            void task_done(std::size_t, T&) {}
+            void finish() {}
+
+        private:
+            in_intent<T> const& intent_;
+        };
+
+        template <typename T>
+        class intent_state<ref_intent<T>>
+        {
+        public:
+            intent_state(ref_intent<T> const& intent, std::size_t)
+              : var_(intent.var)
+            {
+            }
+
+            T& task_state() const
+            {
+                return var_;
+            }
+            void task_done(std::size_t, T&) {}
+            void finish() {}
+
+        private:
+            T& var_;
+        };
+
+        template <typename T>
+        class intent_state<const_ref_intent<T>>
+        {
+        public:
+            intent_state(const_ref_intent<T> const& intent, std::size_t)
+              : var_(intent.var)
+            {
+            }
+
+            T const& task_state() const
+            {
+                return var_;
+            }
+            void task_done(std::size_t, T const&) {}
+            void finish() {}
+
+        private:
+            T const& var_;
+        };
+
+        template <typename T, typename Op>
+        class intent_state<reduce_intent<T, Op>>
+        {
+        public:
+            intent_state(reduce_intent<T, Op> const& intent,
+                std::size_t num_tasks)
+              : intent_(intent)
+              , partials_(num_tasks)
+            {
+            }
+
+            T task_state() const
+            {
+                return intent_.op.identity();
+            }
+            void task_done(std::size_t task, T& acc)
+            {
+                partials_[task].data_ = std::move(acc);
+            }
+            void finish()
+            {
+                intent_.var = intent_.op(
+                    intent_.var, combine_partials(intent_.op, partials_));
+            }
+
+        private:
+            reduce_intent<T, Op> const& intent_;
+            std::vector<hpx::util::cache_aligned_data<T>> partials_;
+        };
+
+        // Run `body(task, args...)` for every task of a loop, where `args`
+        // are the task states of all intents
+        template <typename... Intents, std::size_t... Is, typename Spawn,
+            typename Body>
+        void with_intents(with_clause<Intents...> const& w,
+            std::size_t num_tasks, std::index_sequence<Is...>,
+            Spawn&& spawn, Body&& body)
+        {
+            std::tuple<intent_state<Intents>...> states(
+                intent_state<Intents>(std::get<Is>(w.intents), num_tasks)...);
+
+            spawn([&](std::size_t task, auto&&... loop_args) {
+                std::tuple<decltype(std::get<Is>(states).task_state())...>
+                    args(std::get<Is>(states).task_state()...);
+
+                body(loop_args..., std::get<Is>(args)...);
+
+                (std::get<Is>(states).task_done(task, std::get<Is>(args)),
+                    ...);
+            });
+
+            (std::get<Is>(states).finish(), ...);
+        }
+
+        // Every per-locale task of coforall_locales() runs on its own copy of
+        // this object (received through the spawn tree), thus the values of
+        // the intents it holds are already private to the task and are passed
+        // to `f` by reference
+        template <typename W, typename F>
+        struct with_locales
+        {
+            void operator()(locale const& loc)
+            {
+                std::apply([&](auto&... intents) { f(loc, intents.value...); },
+                    w.intents);
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & w & f;
+                // clang-format on
+            }
+
+            W w;
+            F f;
+        };
+    }    // namespace detail
+
+    //
+    // Invoke f(i, args...) for all i in [first, last), where `args` are
+    // the per-task values of the intents of the with-clause, the equivalent
+    // of
+    //
+    //      forall i in first..last-1 with (intents...) do f(i, args...);
+    //
+    template <typename... Intents, typename F>
+    void forall(std::int64_t first, std::int64_t last,
+        with_clause<Intents...> const& w, F const& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        detail::with_intents(
+            w, num_tasks, std::index_sequence_for<Intents...>(),
+            [&](auto&& task_body) {
+                detail::forall_tasks(first, last, num_tasks,
+                    [&](std::size_t task, std::int64_t lo, std::int64_t hi) {
+                        task_body(task, lo, hi);
+                    });
+            },
+            [&](std::int64_t lo, std::int64_t hi, auto&... args) {
+                for (std::int64_t i = lo; i != hi; ++i)
+                {
+                    f(i, args...);
+                }
+            });
+    }
+
+    template <typename... Intents, typename F>
+    void forall(range const& r, with_clause<Intents...> const& w, F const& f)
+    {
+        forall(std::int64_t(0), r.size(), w,
+            [&](std::int64_t k, auto&... args) { f(r[k], args...); });
+    }
+
+    //
+    // Create a distinct task invoking f(i, args...) for every i in
+    // [first, last), where `args` are the per-task values of the intents,
+    // the equivalent of
+    //
+    //      coforall i in first..last-1 with (intents...) do f(i, args...);
+    //
+    template <typename... Intents, typename F>
+    void coforall(std::int64_t first, std::int64_t last,
+        with_clause<Intents...> const& w, F const& f)
+    {
+        std::int64_t const count = last > first ? last - first : 0;
+        detail::with_intents(
+            w, static_cast<std::size_t>(count),
+            std::index_sequence_for<Intents...>(),
+            [&](auto&& task_body) {
+                coforall(first, last, [&](std::int64_t i) {
+                    task_body(static_cast<std::size_t>(i - first), i);
+                });
+            },
+            [&](std::int64_t i, auto&... args) { f(i, args...); });
+    }
+
+    template <typename... Intents, typename F>
+    void coforall(range const& r, with_clause<Intents...> const& w, F const& f)
+    {
+        coforall(std::int64_t(0), r.size(), w,
+            [&](std::int64_t k, auto&... args) { f(r[k], args...); });
+    }
+
+    //
+    // Run f(loc, values...) on every locale `loc`, where `values` are the
+    // per-locale copies of the values of the `in` intents, the equivalent
+    // of
+    //
+    //      coforall loc in Locales with (in x, ...) do on loc {
+    //          f(loc, x, ...);
+    //      }
+    //
+    // The values are sent along with `f` (once per locale), `f` has to be
+    // serializable.
+    //
+    template <typename... Ts, typename F>
+    void coforall_locales(with_clause<in_intent<Ts>...> const& w, F const& f)
+    {
+        coforall_locales(
+            detail::with_locales<with_clause<in_intent<Ts>...>, F>{w, f});
+    }
+}    // namespace chapel
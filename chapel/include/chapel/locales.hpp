@@ -0,0 +1,107 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/serialization.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Chapel's built-in `Locales` array and `here`
+//
+// The properties of all locales are resolved once while the runtime starts
+// up and are replicated to every locality. Afterwards, querying them is
+// nothing more than a memory read, which makes them safe to use inside of
+// hot loop bodies (unlike hpx::get_num_localities() or
+// hpx::get_locality_name(), which may have to consult AGAS).
+
+namespace chapel {
+
+    //
+    // The NUMA domains of a locale are exposed as its sublocales, the
+    // children of the locale (Chapel's hierarchical locale model).
+    //
+    class sublocale
+    {
+    public:
+        // unique ID in 0..getChildCount()-1 of the parent locale
+        std::uint32_t id = 0;
+
+        // the NUMA domain (as numbered by HPX's topology)
+        std::uint32_t numaDomain = 0;
+
+        // number of worker threads (of the parent locale) running on the
+        // cores of the NUMA domain
+        std::size_t maxTaskPar = 1;
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & id & numaDomain & maxTaskPar;
+            // clang-format on
+        }
+    };
+
+    class locale
+    {
+    public:
+        // unique ID in 0..numLocales-1
+        std::uint32_t id = 0;
+
+        // name of the locale (similar to UNIX ``hostname``)
+        std::string name;
+
+        // number of tasks the locale is capable of executing in parallel
+        std::size_t maxTaskPar = 1;
+
+        // the sublocales (NUMA domains) of the locale, at least one
+        std::vector<sublocale> children;
+
+        std::size_t getChildCount() const
+        {
+            return children.size();
+        }
+
+        sublocale const& getChild(std::size_t i) const
+        {
+            return children[i];
+        }
+
+    private:
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & id & name & maxTaskPar & children;
+            // clang-format on
+        }
+    };
+
+    // All locales the program is running on, indexed by their ID
+    std::vector<locale> const& Locales();
+
+    // The number of locales the program is running on
+    std::uint32_t numLocales();
+
+    // The locale the calling task is running on
+    locale const& here();
+
+    namespace detail {
+
+        // The NUMA domain of the cores the worker thread `worker` of this
+        // locale runs on
+        std::uint32_t numa_domain_of_worker(std::size_t worker);
+    }    // namespace detail
+}    // namespace chapel
@@ -0,0 +1,75 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chapel/detail/loop_trace.hpp>
+#include <chapel/detail/task_counter.hpp>
+
+#include <iosfwd>
+
+// Tracing of forall- and coforall-loops
+//
+// If traceLoops is set (see config.hpp), every forall- and coforall-loop
+// records its wall time, number of tasks, the smallest and largest chunk of
+// iterations executed by a task, the busy time of the tasks (the idle time
+// of the workers follows from it), and the number of tasks that were placed
+// on a NUMA domain but ran on a worker thread of another one (i.e. that were
+// stolen across NUMA domains). Every task is recorded as well, along with
+// the worker thread that executed it.
+//
+// The records are kept in a ring buffer of traceBufferSize entries per
+// locale, the oldest records are overwritten. Loops are named by the
+// innermost loop_name of the task executing them, which is inherited by the
+// tasks it creates (so loops nested in the body of a named loop carry its
+// name as well):
+//
+//      {
+//          chapel::loop_name name("forall_1");
+//          chapel::forall(chapel::range(1, numMessages), forall_1());
+//      }
+//
+// or, if there is none, after the annotation (description) of the task,
+// e.g. as set by hpx::scoped_annotation.
+//
+// When the runtime shuts down, every locale writes its records to
+// loop-trace.<locale>.json in the Chrome trace format (chrome://tracing,
+// https://ui.perfetto.dev), where each worker thread is shown as a distinct
+// thread and all loops are shown on an additional thread named `loops`. If
+// HPX was built with APEX support, the statistics of every loop are also
+// passed to APEX as samples named chapel/<loop name>/<statistic>.
+
+namespace chapel {
+
+    //
+    // Names the loops executed by the calling task while the object exists,
+    // `name` has to outlive it. Does nothing unless traceLoops is set.
+    //
+    class loop_name
+    {
+    public:
+        explicit loop_name(char const* name);
+        ~loop_name();
+
+        loop_name(loop_name const&) = delete;
+        loop_name& operator=(loop_name const&) = delete;
+
+    private:
+        bool const active_;
+        detail::task_context context_;
+        detail::task_context const* previous_ = nullptr;
+    };
+
+    //
+    // Write the records of this locale to `os` in the Chrome trace format
+    //
+    void write_loop_trace(std::ostream& os);
+
+    //
+    // Discard all records of this locale
+    //
+    void clear_loop_trace();
+}    // namespace chapel
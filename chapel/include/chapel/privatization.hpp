@@ -0,0 +1,173 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <chapel/coforall_locales.hpp>
+#include <chapel/detail/instance_registry.hpp>
+#include <chapel/locales.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Privatized (replicated) objects
+//
+// Chapel privatizes the descriptors of distributed objects: every locale
+// holds its own replica, which is found through a privatization ID (pid)
+// without resolving a global address or communicating. privatized<T> does
+// the same for any serializable T:
+//
+//      chapel::privatized<params> p(params{...});    // one copy per locale
+//
+//      chapel::coforall_locales(body{p.id()});
+//
+//      // inside of body (executed on any locale)
+//      params& mine = chapel::get_privatized<params>(pid);
+//
+// Looking up the replica is a couple of (uncontended) loads, so it can be
+// done inside of hot loops. Updates are broadcast to all replicas using
+// broadcast() or set(), the replicas are never synchronized otherwise.
+
+namespace chapel {
+
+    //
+    // Return the replica of the privatized object `pid` on this locale
+    //
+    template <typename T>
+    T& get_privatized(std::uint64_t pid)
+    {
+        return detail::get_instance<T>(pid);
+    }
+
+    namespace detail {
+
+        template <typename T>
+        struct privatized_create
+        {
+            std::shared_ptr<void> operator()(locale const&) const
+            {
+                return std::make_shared<T>(value);
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & value;
+                // clang-format on
+            }
+
+            T value;
+        };
+
+        template <typename T, typename F>
+        struct privatized_update
+        {
+            void operator()(locale const&) const
+            {
+                f(get_privatized<T>(id));
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & id & f;
+                // clang-format on
+            }
+
+            std::uint64_t id = 0;
+            F f;
+        };
+
+        template <typename T>
+        struct privatized_assign
+        {
+            void operator()(T& replica) const
+            {
+                replica = value;
+            }
+
+            template <typename Archive>
+            void serialize(Archive& ar, unsigned)
+            {
+                // clang-format off
+                ar & value;
+                // clang-format on
+            }
+
+            T value;
+        };
+    }    // namespace detail
+
+    template <typename T>
+    class privatized
+    {
+    public:
+        // Create a replica of `value` on every locale, the value is sent
+        // once per locale (through the spawn tree of coforall_locales)
+        explicit privatized(T const& value)
+          : id_(detail::create_instances(detail::privatized_create<T>{value}))
+        {
+        }
+
+        privatized(privatized const&) = delete;
+        privatized& operator=(privatized const&) = delete;
+
+        privatized(privatized&& rhs) noexcept
+          : id_(std::exchange(rhs.id_, 0))
+        {
+        }
+
+        // Releasing the replicas communicates with all locales, which may
+        // throw
+        privatized& operator=(privatized&& rhs)
+        {
+            if (this != &rhs)
+            {
+                detail::release_instances(id_);
+                id_ = std::exchange(rhs.id_, 0);
+            }
+            return *this;
+        }
+
+        ~privatized()
+        {
+            detail::release_instances(id_, "chapel::privatized");
+        }
+
+        // The privatization ID, this is what should be captured by tasks
+        // running on other locales
+        std::uint64_t id() const
+        {
+            return id_;
+        }
+
+        // The replica on this locale
+        T& local() const
+        {
+            return get_privatized<T>(id_);
+        }
+
+        // Invoke f(replica) on every locale and wait for all of them, `f`
+        // has to be serializable
+        template <typename F>
+        void broadcast(F const& f)
+        {
+            coforall_locales(detail::privatized_update<T, F>{id_, f});
+        }
+
+        // Replace all replicas with `value`
+        void set(T const& value)
+        {
+            broadcast(detail::privatized_assign<T>{value});
+        }
+
+    private:
+        std::uint64_t id_ = 0;
+    };
+}    // namespace chapel
@@ -0,0 +1,202 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/assert.hpp>
+#include <hpx/modules/serialization.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// Chapel's ranges
+//
+// Unlike the remainder of this library, ranges use Chapel's inclusive
+// bounds, which allows for Chapel code to be translated literally:
+//
+//      1..n                    chapel::range(1, n)
+//      0..#n                   chapel::counted(0, n)
+//      1..n by 2               chapel::range(1, n).by(2)
+//      1..n by -1              chapel::range(1, n).by(-1)
+//
+// A range is represented by its first index (in iteration order), its
+// stride, and the number of its indices, thus ranges are random-access and
+// can be partitioned between tasks without iterating over them.
+
+namespace chapel {
+
+    class range
+    {
+    public:
+        range() = default;
+
+        // low..high
+        range(std::int64_t low, std::int64_t high)
+          : first_(low)
+          , size_(high >= low ? high - low + 1 : 0)
+        {
+        }
+
+        // number of indices in the range
+        std::int64_t size() const
+        {
+            return size_;
+        }
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        std::int64_t stride() const
+        {
+            return stride_;
+        }
+
+        // first and last index in iteration order, the range must not be
+        // empty
+        std::int64_t first() const
+        {
+            HPX_ASSERT(size_ != 0);
+            return first_;
+        }
+        std::int64_t last() const
+        {
+            HPX_ASSERT(size_ != 0);
+            return first_ + (size_ - 1) * stride_;
+        }
+
+        // smallest and largest index, the range must not be empty
+        std::int64_t low() const
+        {
+            return stride_ > 0 ? first() : last();
+        }
+        std::int64_t high() const
+        {
+            return stride_ > 0 ? last() : first();
+        }
+
+        // the k'th index in iteration order, 0 <= k < size() (Chapel's
+        // `orderToIndex`)
+        std::int64_t operator[](std::int64_t k) const
+        {
+            HPX_ASSERT(k >= 0 && k < size_);
+            return first_ + k * stride_;
+        }
+
+        // the position of `idx` in iteration order, or -1 if the range does
+        // not contain it (Chapel's `indexOrder`)
+        std::int64_t indexOrder(std::int64_t idx) const
+        {
+            std::int64_t const distance = idx - first_;
+            if (distance % stride_ != 0)
+                return -1;
+
+            std::int64_t const k = distance / stride_;
+            return k >= 0 && k < size_ ? k : -1;
+        }
+
+        bool contains(std::int64_t idx) const
+        {
+            return indexOrder(idx) != -1;
+        }
+
+        // r by step, a negative step reverses the direction of iteration
+        range by(std::int64_t step) const
+        {
+            HPX_ASSERT(step != 0);
+
+            std::int64_t const abs_step = step < 0 ? -step : step;
+            std::int64_t const size = (size_ + abs_step - 1) / abs_step;
+
+            if (step > 0 || size_ == 0)
+            {
+                return range(first_, stride_ * step, size);
+            }
+            return range(last(), stride_ * step, size);
+        }
+
+        // the first `count` indices of the range (Chapel's `r # count`)
+        range take(std::int64_t count) const
+        {
+            HPX_ASSERT(count >= 0 && count <= size_);
+            return range(first_, stride_, count);
+        }
+
+        friend range counted(std::int64_t low, std::int64_t count);
+
+    private:
+        range(std::int64_t first, std::int64_t stride, std::int64_t size)
+          : first_(first)
+          , stride_(stride)
+          , size_(size)
+        {
+        }
+
+        friend class hpx::serialization::access;
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & first_ & stride_ & size_;
+            // clang-format on
+        }
+
+        std::int64_t first_ = 0;
+        std::int64_t stride_ = 1;
+        std::int64_t size_ = 0;
+    };
+
+    // low..#count
+    inline range counted(std::int64_t low, std::int64_t count)
+    {
+        return range(low, 1, count < 0 ? 0 : count);
+    }
+
+    //
+    // Invoke f(i) for all indices i of the range `r`, the equivalent of
+    //
+    //      forall i in r do f(i);
+    //
+    // The range is partitioned into contiguous chunks of indices (in
+    // iteration order), one per task, as for any other forall-loop.
+    //
+    template <typename F>
+    void forall(range const& r, F const& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(r.size());
+        detail::forall_tasks(0, r.size(), num_tasks,
+            [&](std::size_t, std::int64_t lo, std::int64_t hi) {
+                for (std::int64_t k = lo; k != hi; ++k)
+                {
+                    f(r[k]);
+                }
+            });
+    }
+
+    //
+    // Create a distinct task invoking f(i) for every index i of the range
+    // `r`, the equivalent of
+    //
+    //      coforall i in r do f(i);
+    //
+    template <typename F>
+    void coforall(
+        hpx::threads::thread_stacksize stacksize, range const& r, F&& f)
+    {
+        coforall(stacksize, 0, r.size(), [&](std::int64_t k) { f(r[k]); });
+    }
+
+    template <typename F>
+    void coforall(range const& r, F&& f)
+    {
+        coforall(hpx::threads::thread_stacksize::default_, r, f);
+    }
+}    // namespace chapel
@@ -0,0 +1,389 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/algorithms.hpp>
+#include <hpx/modules/concurrency.hpp>
+#include <hpx/modules/execution.hpp>
+#include <hpx/modules/iterator_support.hpp>
+
+#include <chapel/detail/forall_tasks.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Reductions (``op reduce expr``) and reduce intents (``with (op reduce x)``)
+//
+// A reduction operator is a function object `op` providing `op.identity()`
+// and the associative combining operation `op(a, b)`. Each task executing a
+// forall-loop accumulates into a private accumulator, the accumulators are
+// stored in cache line padded slots once the task has finished, and the
+// partial results are then combined pairwise (in a tree). No atomics or locks
+// are involved. Besides the standard Chapel operators defined below, any
+// user-defined operator satisfying the requirements above can be used, see
+// also make_reduce_op(). Operators used for distributed reductions have to be
+// serializable.
+//
+// Unless an operator declares itself commutative (with a member
+// `static constexpr bool commutative = true`, as all standard operators
+// do), the values are combined in index order. Only the values combined by
+// commutative operators may be reordered, e.g. to vectorize the loop.
+
+namespace chapel {
+
+    template <typename T>
+    struct sum_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(0);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs + rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct product_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(1);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs * rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct min_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return (std::numeric_limits<T>::max)();
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return rhs < lhs ? rhs : lhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct max_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return std::numeric_limits<T>::lowest();
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs < rhs ? rhs : lhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct logical_and_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(true);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs && rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct logical_or_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(false);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs || rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct bit_and_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return ~T(0);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs & rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct bit_or_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(0);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs | rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    template <typename T>
+    struct bit_xor_op
+    {
+        static constexpr bool commutative = true;
+
+        constexpr T identity() const
+        {
+            return T(0);
+        }
+        constexpr T operator()(T const& lhs, T const& rhs) const
+        {
+            return lhs ^ rhs;
+        }
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
+        }
+    };
+
+    //
+    // A user-defined reduction operator made from an identity value and an
+    // associative binary function, which is commutative if `Commutative` is
+    // set.
+    //
+    template <typename T, typename F, bool Commutative = false>
+    struct reduce_op
+    {
+        static constexpr bool commutative = Commutative;
+
+        T identity() const
+        {
+            return identity_;
+        }
+        T operator()(T const& lhs, T const& rhs) const
+        {
+            return op_(lhs, rhs);
+        }
+
+        template <typename Archive>
+        void serialize(Archive& ar, unsigned)
+        {
+            // clang-format off
+            ar & identity_ & op_;
+            // clang-format on
+        }
+
+        T identity_;
+        F op_;
+    };
+
+    template <typename T, typename F>
+    reduce_op<T, std::decay_t<F>> make_reduce_op(T identity, F&& op)
+    {
+        return reduce_op<T, std::decay_t<F>>{
+            std::move(identity), std::forward<F>(op)};
+    }
+
+    // Same as make_reduce_op(), for a commutative function `op`, the values
+    // may be combined in any order
+    template <typename T, typename F>
+    reduce_op<T, std::decay_t<F>, true> make_commutative_reduce_op(
+        T identity, F&& op)
+    {
+        return reduce_op<T, std::decay_t<F>, true>{
+            std::move(identity), std::forward<F>(op)};
+    }
+
+    template <typename Op>
+    using reduce_result_t =
+        std::decay_t<decltype(std::declval<Op const&>().identity())>;
+
+    namespace detail {
+
+        template <typename Op, typename Enable = void>
+        struct is_commutative : std::false_type
+        {
+        };
+
+        template <typename Op>
+        struct is_commutative<Op, std::void_t<decltype(Op::commutative)>>
+          : std::bool_constant<Op::commutative>
+        {
+        };
+
+        // Combine the partial results of all tasks pairwise, keeping the
+        // order of the operands intact.
+        template <typename Op, typename T>
+        T combine_partials(Op const& op,
+            std::vector<hpx::util::cache_aligned_data<T>>& partials)
+        {
+            std::size_t const count = partials.size();
+            if (count == 0)
+                return op.identity();
+
+            for (std::size_t stride = 1; stride < count; stride *= 2)
+            {
+                for (std::size_t i = 0; i + stride < count; i += 2 * stride)
+                {
+                    partials[i].data_ =
+                        op(partials[i].data_, partials[i + stride].data_);
+                }
+            }
+            return std::move(partials[0].data_);
+        }
+    }    // namespace detail
+
+    //
+    // Reduce the values f(i) for all i in [first, last) using `op`, the
+    // equivalent of
+    //
+    //      op reduce [i in first..last-1] f(i)
+    //
+    // For commutative operators, the local accumulation of every task is
+    // expressed as an unsequenced transform_reduce, which allows for it to be
+    // vectorized. Otherwise every task accumulates its values in index order.
+    //
+    template <typename Op, typename F>
+    reduce_result_t<Op> reduce(
+        std::int64_t first, std::int64_t last, Op const& op, F&& f)
+    {
+        using result_type = reduce_result_t<Op>;
+
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        std::vector<hpx::util::cache_aligned_data<result_type>> partials(
+            num_tasks);
+
+        detail::forall_tasks(first, last, num_tasks,
+            [&](std::size_t task, std::int64_t lo, std::int64_t hi) {
+                if constexpr (detail::is_commutative<Op>::value)
+                {
+                    partials[task].data_ =
+                        hpx::transform_reduce(hpx::execution::unseq,
+                            hpx::util::counting_iterator<std::int64_t>(lo),
+                            hpx::util::counting_iterator<std::int64_t>(hi),
+                            op.identity(), op, f);
+                }
+                else
+                {
+                    result_type acc = op.identity();
+                    for (std::int64_t i = lo; i != hi; ++i)
+                    {
+                        acc = op(acc, f(i));
+                    }
+                    partials[task].data_ = std::move(acc);
+                }
+            });
+
+        return detail::combine_partials(op, partials);
+    }
+
+    //
+    // A reduce intent, ``with (op reduce var)``, gives every task executing
+    // a forall-loop a private accumulator (initialized to the identity of
+    // `op`) that is passed to the loop body. Once the loop has finished, the
+    // accumulators are combined into `var`.
+    //
+    template <typename T, typename Op>
+    struct reduce_intent
+    {
+        T& var;
+        Op op;
+    };
+
+    template <typename T, typename Op>
+    reduce_intent<T, Op> with_reduce(T& var, Op op)
+    {
+        return reduce_intent<T, Op>{var, std::move(op)};
+    }
+
+    //
+    // Invoke f(i, acc) for all i in [first, last) where `acc` is the
+    // accumulator of the task executing the iteration, the equivalent of
+    //
+    //      forall i in first..last-1 with (op reduce var) do f(i, var);
+    //
+    template <typename T, typename Op, typename F>
+    void forall(std::int64_t first, std::int64_t last,
+        reduce_intent<T, Op> intent, F&& f)
+    {
+        std::size_t const num_tasks = detail::forall_num_tasks(last - first);
+        std::vector<hpx::util::cache_aligned_data<T>> partials(num_tasks);
+
+        detail::forall_tasks(first, last, num_tasks,
+            [&](std::size_t task, std::int64_t lo, std::int64_t hi) {
+                T acc = intent.op.identity();
+                for (std::int64_t i = lo; i != hi; ++i)
+                {
+                    f(i, acc);
+                }
+                partials[task].data_ = std::move(acc);
+            });
+
+        intent.var = intent.op(
+            intent.var, detail::combine_partials(intent.op, partials));
+    }
+}    // namespace chapel
@@ -0,0 +1,342 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/assert.hpp>
+#include <hpx/modules/format.hpp>
+
+#include <chapel/task_arena.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+// Chapel's string type
+//
+// Messages are usually built by appending a few literals and numbers to a
+// string. chapel::string stores up to inline_capacity characters without
+// allocating any memory, and converts integral values in place (using
+// std::to_chars) instead of creating temporary strings:
+//
+//      chapel::string message("Hello, world! (from ");
+//      message.append("task ", tid + 1, " of ", tasksPerLocale, ")");
+//
+// Longer strings are allocated from the task_arena given on construction,
+// if any, or from the heap otherwise. A string using an arena must not
+// outlive it, copies of it are allocated from the heap (or the arena of the
+// target), while moving it transfers its storage and its arena.
+
+namespace chapel {
+
+    namespace detail {
+
+        // Character types appended as a single code unit
+        template <typename T>
+        inline constexpr bool is_narrow_char_v = std::is_same_v<T, char> ||
+            std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>;
+
+#if defined(__cpp_char8_t)
+        template <>
+        inline constexpr bool is_narrow_char_v<char8_t> = true;
+#endif
+
+        // Character types appended encoded as UTF-8
+        template <typename T>
+        inline constexpr bool is_wide_char_v = std::is_same_v<T, wchar_t> ||
+            std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+    }    // namespace detail
+
+    class string
+    {
+    public:
+        static constexpr std::size_t inline_capacity = 127;
+
+        string() noexcept
+        {
+            buffer_[0] = '\0';
+        }
+
+        explicit string(task_arena& arena) noexcept
+          : arena_(&arena)
+        {
+            buffer_[0] = '\0';
+        }
+
+        string(std::string_view value)
+        {
+            buffer_[0] = '\0';
+            append_view(value);
+        }
+
+        string(char const* value)
+          : string(std::string_view(value))
+        {
+        }
+
+        string(std::string_view value, task_arena& arena)
+          : arena_(&arena)
+        {
+            buffer_[0] = '\0';
+            append_view(value);
+        }
+
+        string(string const& rhs)
+        {
+            buffer_[0] = '\0';
+            append_view(rhs.view());
+        }
+
+        string(string&& rhs) noexcept
+        {
+            move_from(rhs);
+        }
+
+        string& operator=(string const& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                append_view(rhs.view());
+            }
+            return *this;
+        }
+
+        string& operator=(string&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                deallocate();
+                move_from(rhs);
+            }
+            return *this;
+        }
+
+        ~string()
+        {
+            deallocate();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return capacity_;
+        }
+
+        char const* data() const noexcept
+        {
+            return data_;
+        }
+
+        char const* c_str() const noexcept
+        {
+            return data_;
+        }
+
+        std::string_view view() const noexcept
+        {
+            return std::string_view(data_, size_);
+        }
+
+        operator std::string_view() const noexcept
+        {
+            return view();
+        }
+
+        void clear() noexcept
+        {
+            size_ = 0;
+            data_[0] = '\0';
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            if (capacity > capacity_)
+            {
+                grow(capacity);
+            }
+        }
+
+        // Append all arguments: strings and characters as they are (wide
+        // characters encoded as UTF-8), integral values in decimal, bools as
+        // "true" or "false"
+        template <typename... Ts>
+        string& append(Ts const&... ts)
+        {
+            (append_one(ts), ...);
+            return *this;
+        }
+
+        template <typename T>
+        string& operator+=(T const& value)
+        {
+            append_one(value);
+            return *this;
+        }
+
+        friend bool operator==(string const& lhs, string const& rhs) noexcept
+        {
+            return lhs.view() == rhs.view();
+        }
+
+        friend bool operator!=(string const& lhs, string const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        bool is_inline() const noexcept
+        {
+            return data_ == buffer_;
+        }
+
+        void append_view(std::string_view value)
+        {
+            reserve(size_ + value.size());
+            std::memcpy(data_ + size_, value.data(), value.size());
+            size_ += value.size();
+            data_[size_] = '\0';
+        }
+
+        template <typename T>
+        void append_one(T const& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                append_view(value ? "true" : "false");
+            }
+            else if constexpr (detail::is_narrow_char_v<T>)
+            {
+                reserve(size_ + 1);
+                data_[size_++] = static_cast<char>(value);
+                data_[size_] = '\0';
+            }
+            else if constexpr (detail::is_wide_char_v<T>)
+            {
+                append_code_point(static_cast<char32_t>(value));
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                // enough for all digits and the sign of any value of T
+                reserve(size_ + std::numeric_limits<T>::digits10 + 2);
+                auto const result =
+                    std::to_chars(data_ + size_, data_ + capacity_, value);
+                HPX_ASSERT(result.ec == std::errc());
+                size_ = result.ptr - data_;
+                data_[size_] = '\0';
+            }
+            else if constexpr (
+                std::is_convertible_v<T const&, std::string_view>)
+            {
+                append_view(value);
+            }
+            else
+            {
+                append_view(hpx::util::format("{}", value));
+            }
+        }
+
+        // Append `c` encoded as UTF-8, invalid code points (e.g. unpaired
+        // UTF-16 surrogates) are replaced by U+FFFD
+        void append_code_point(char32_t c)
+        {
+            if ((c >= 0xd800 && c < 0xe000) || c > 0x10ffff)
+            {
+                c = 0xfffd;
+            }
+
+            reserve(size_ + 4);
+            if (c < 0x80)
+            {
+                data_[size_++] = static_cast<char>(c);
+            }
+            else if (c < 0x800)
+            {
+                data_[size_++] = static_cast<char>(0xc0 | (c >> 6));
+                data_[size_++] = static_cast<char>(0x80 | (c & 0x3f));
+            }
+            else if (c < 0x10000)
+            {
+                data_[size_++] = static_cast<char>(0xe0 | (c >> 12));
+                data_[size_++] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+                data_[size_++] = static_cast<char>(0x80 | (c & 0x3f));
+            }
+            else
+            {
+                data_[size_++] = static_cast<char>(0xf0 | (c >> 18));
+                data_[size_++] = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+                data_[size_++] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+                data_[size_++] = static_cast<char>(0x80 | (c & 0x3f));
+            }
+            data_[size_] = '\0';
+        }
+
+        void grow(std::size_t capacity)
+        {
+            capacity = (std::max)(capacity, 2 * capacity_);
+
+            char* data = arena_ != nullptr ?
+                static_cast<char*>(arena_->allocate(capacity + 1, 1)) :
+                new char[capacity + 1];
+            std::memcpy(data, data_, size_ + 1);
+
+            deallocate();
+            data_ = data;
+            capacity_ = capacity;
+        }
+
+        // memory allocated from an arena is released along with the arena
+        void deallocate() noexcept
+        {
+            if (!is_inline() && arena_ == nullptr)
+            {
+                delete[] data_;
+            }
+        }
+
+        void move_from(string& rhs) noexcept
+        {
+            arena_ = rhs.arena_;
+            size_ = rhs.size_;
+            if (rhs.is_inline())
+            {
+                std::memcpy(buffer_, rhs.buffer_, rhs.size_ + 1);
+                data_ = buffer_;
+                capacity_ = inline_capacity;
+            }
+            else
+            {
+                data_ = rhs.data_;
+                capacity_ = rhs.capacity_;
+            }
+
+            rhs.data_ = rhs.buffer_;
+            rhs.size_ = 0;
+            rhs.capacity_ = inline_capacity;
+            rhs.buffer_[0] = '\0';
+        }
+
+        char* data_ = buffer_;
+        std::size_t size_ = 0;
+        std::size_t capacity_ = inline_capacity;
+        task_arena* arena_ = nullptr;
+        char buffer_[inline_capacity + 1];
+    };
+}    // namespace chapel
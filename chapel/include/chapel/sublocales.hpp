@@ -0,0 +1,57 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/locales.hpp>
+
+#include <cstdint>
+
+// Placement of tasks on the sublocales (NUMA domains) of the current locale
+//
+// Every locale has one sublocale per NUMA domain hosting worker threads
+// (see locale::getChild()). Tasks placed on a sublocale are scheduled on
+// the cores of its NUMA domain. The iterations of forall-loops are already
+// split between the NUMA domains of the locale before being split between
+// the cores (see detail::forall_tasks).
+
+namespace chapel {
+
+    //
+    // Execute `f()` as a task on the cores of the sublocale `s` and wait for
+    // it to finish, the equivalent of
+    //
+    //      on here.getChild(i) do f();
+    //
+    template <typename F>
+    void on(sublocale const& s, F&& f)
+    {
+        detail::coforall_hinted(
+            hpx::threads::thread_stacksize::default_, 0, 1,
+            [&](std::int64_t) { return detail::schedule_hint(s); },
+            [&](std::int64_t) { f(); });
+    }
+
+    //
+    // Create a distinct task per sublocale of the current locale running
+    // `f(s)` on the cores of the sublocale `s`, the equivalent of
+    //
+    //      coforall s in here.getChildren() do on s do f(s);
+    //
+    template <typename F>
+    void coforall_sublocales(F&& f)
+    {
+        auto const& children = here().children;
+        detail::coforall_hinted(
+            hpx::threads::thread_stacksize::default_, 0,
+            static_cast<std::int64_t>(children.size()),
+            [&](std::int64_t i) { return detail::schedule_hint(children[i]); },
+            [&](std::int64_t i) { f(children[i]); });
+    }
+}    // namespace chapel
@@ -0,0 +1,267 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+// Chapel's `sync` and `single` variables
+//
+// Both carry a full/empty state in addition to their value. Reading a sync
+// variable (readFE) waits until it is full and leaves it empty, writing it
+// (writeEF) waits until it is empty and leaves it full, which makes them
+// suitable for handing values from one task to another. A single variable
+// can be written only once, and reading it waits until it has been written.
+//
+// The state is kept in a single atomic. Operations that find the variable
+// in the expected state complete with one compare-and-swap, only tasks that
+// have to wait acquire a lock and suspend on a condition variable (which
+// suspends the calling HPX thread, not the underlying OS thread).
+
+namespace chapel {
+
+    namespace detail {
+
+        template <typename T>
+        class full_empty
+        {
+        protected:
+            enum : int
+            {
+                empty = 0,
+                full = 1,
+                busy = 2    // an operation is accessing the value
+            };
+
+            full_empty() = default;
+
+            explicit full_empty(T value)
+              : value_(std::move(value))
+              , state_(full)
+            {
+            }
+
+            full_empty(full_empty const&) = delete;
+            full_empty& operator=(full_empty const&) = delete;
+
+            // Wait for the variable to be in state `from` and lock it
+            void acquire(int from)
+            {
+                int expected = from;
+                if (!state_.compare_exchange_strong(expected, busy))
+                {
+                    acquire_slow(from);
+                }
+            }
+
+            // Lock the variable regardless of its state, return the state
+            int acquire_any()
+            {
+                int expected = state_.load();
+                if (expected != busy &&
+                    state_.compare_exchange_strong(expected, busy))
+                {
+                    return expected;
+                }
+                return acquire_slow(busy);
+            }
+
+            // Unlock the variable, leaving it in state `to`
+            void release(int to)
+            {
+                state_.store(to);
+                if (waiters_.load() != 0)
+                {
+                    std::lock_guard<hpx::spinlock> l(mtx_);
+                    cv_.notify_all();
+                }
+            }
+
+            int state() const
+            {
+                return state_.load();
+            }
+
+            T value_ = T();
+
+        private:
+            // Wait for the variable to be in state `from` (any state other
+            // than busy if `from` is busy) and lock it, return the state
+            int acquire_slow(int from)
+            {
+                std::unique_lock<hpx::spinlock> l(mtx_);
+                ++waiters_;
+
+                int expected;
+                while (true)
+                {
+                    expected = from == busy ? state_.load() : from;
+                    if (expected != busy &&
+                        state_.compare_exchange_strong(expected, busy))
+                    {
+                        break;
+                    }
+
+                    // release() notifies after changing the state, as we are
+                    // registered as a waiter this can't be missed
+                    cv_.wait(l);
+                }
+
+                --waiters_;
+                return expected;
+            }
+
+            std::atomic<int> state_{empty};
+            std::atomic<std::size_t> waiters_{0};
+            hpx::spinlock mtx_;
+            hpx::condition_variable_any cv_;
+        };
+    }    // namespace detail
+
+    template <typename T>
+    class sync : detail::full_empty<T>
+    {
+        using base_type = detail::full_empty<T>;
+
+    public:
+        // the variable starts out empty
+        sync() = default;
+
+        // the variable starts out full
+        explicit sync(T value)
+          : base_type(std::move(value))
+        {
+        }
+
+        // wait until full, read the value, and leave empty
+        T readFE()
+        {
+            this->acquire(base_type::full);
+            T value = std::move(this->value_);
+            this->release(base_type::empty);
+            return value;
+        }
+
+        // wait until full, read the value, and leave full
+        T readFF()
+        {
+            this->acquire(base_type::full);
+            T value = this->value_;
+            this->release(base_type::full);
+            return value;
+        }
+
+        // read the value regardless of the state, leaving the state unchanged
+        T readXX()
+        {
+            int const state = this->acquire_any();
+            T value = this->value_;
+            this->release(state);
+            return value;
+        }
+
+        // wait until empty, write the value, and leave full
+        void writeEF(T value)
+        {
+            this->acquire(base_type::empty);
+            this->value_ = std::move(value);
+            this->release(base_type::full);
+        }
+
+        // wait until full, write the value, and leave full
+        void writeFF(T value)
+        {
+            this->acquire(base_type::full);
+            this->value_ = std::move(value);
+            this->release(base_type::full);
+        }
+
+        // write the value regardless of the state, and leave full
+        void writeXF(T value)
+        {
+            this->acquire_any();
+            this->value_ = std::move(value);
+            this->release(base_type::full);
+        }
+
+        // reset the value to its default, and leave empty
+        void reset()
+        {
+            this->acquire_any();
+            this->value_ = T();
+            this->release(base_type::empty);
+        }
+
+        bool isFull() const
+        {
+            return this->state() == base_type::full;
+        }
+    };
+
+    template <typename T>
+    class single : detail::full_empty<T>
+    {
+        using base_type = detail::full_empty<T>;
+
+    public:
+        // the variable starts out empty
+        single() = default;
+
+        // the variable starts out full
+        explicit single(T value)
+          : base_type(std::move(value))
+        {
+        }
+
+        // wait until full and read the value, the value can't change
+        // anymore once the variable is full, thus no locking is required
+        T readFF()
+        {
+            if (this->state() != base_type::full)
+            {
+                this->acquire(base_type::full);
+                this->release(base_type::full);
+            }
+            return this->value_;
+        }
+
+        // read the value regardless of the state
+        T readXX()
+        {
+            int const state = this->acquire_any();
+            T value = this->value_;
+            this->release(state);
+            return value;
+        }
+
+        // write the value and leave full, a single variable can be written
+        // only once
+        void writeEF(T value)
+        {
+            if (this->acquire_any() != base_type::empty)
+            {
+                this->release(base_type::full);
+                HPX_THROW_EXCEPTION(hpx::error::invalid_status,
+                    "chapel::single::writeEF",
+                    "single variable has already been written");
+            }
+
+            this->value_ = std::move(value);
+            this->release(base_type::full);
+        }
+
+        bool isFull() const
+        {
+            return this->state() == base_type::full;
+        }
+    };
+}    // namespace chapel
@@ -0,0 +1,82 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Per-task arena allocation
+//
+// A task_arena hands out memory by advancing a pointer through blocks of
+// arena_block_size bytes, and releases all of it at once when it is reset
+// or destroyed. Declared in the body of a task, it is the task's private
+// arena that is released when the task ends:
+//
+//      void operator()(std::int64_t tid) const
+//      {
+//          chapel::task_arena arena;
+//          chapel::string message("Hello", arena);
+//          ...
+//      }    // all memory allocated from `arena` is released here
+//
+// The blocks are recycled through a cache owned by the worker thread, thus
+// once the cache is warm, allocation heavy tasks don't call into the global
+// allocator at all (which otherwise tends to limit scalability). An arena
+// must be used by a single task only, nothing allocated from it may outlive
+// it.
+
+namespace chapel {
+
+    class task_arena
+    {
+    public:
+        // requests larger than this are served by the global allocator (and
+        // are still released along with the arena)
+        static constexpr std::size_t arena_block_size = 16 * 1024;
+
+        task_arena() = default;
+
+        task_arena(task_arena const&) = delete;
+        task_arena& operator=(task_arena const&) = delete;
+
+        ~task_arena()
+        {
+            reset();
+        }
+
+        void* allocate(std::size_t size,
+            std::size_t alignment = alignof(std::max_align_t))
+        {
+            auto const current = reinterpret_cast<std::uintptr_t>(current_);
+            std::uintptr_t const aligned =
+                (current + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+            if (current_ != nullptr && aligned + size <= end_)
+            {
+                current_ = reinterpret_cast<char*>(aligned + size);
+                return reinterpret_cast<void*>(aligned);
+            }
+            return allocate_slow(size, alignment);
+        }
+
+        // Release all memory allocated from the arena
+        void reset();
+
+    private:
+        struct block
+        {
+            block* next;
+        };
+
+        void* allocate_slow(std::size_t size, std::size_t alignment);
+
+        block* blocks_ = nullptr;    // blocks of arena_block_size bytes
+        block* large_ = nullptr;     // oversized allocations
+        char* current_ = nullptr;
+        std::uintptr_t end_ = 0;
+    };
+}    // namespace chapel
@@ -0,0 +1,209 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/format.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/string.hpp>
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Chapel's `writeln()` writes its arguments followed by a newline to the
+// console. Writing every message to `hpx::cout` directly serializes all tasks
+// on the console stream and forwards each message to locality 0 separately.
+// Instead, messages are appended to a buffer owned by the worker thread
+// executing the task, and full buffers are handed to the console as a single
+// batch. All buffers of a locality are flushed by `flush_writeln()` and at
+// the latest when the runtime shuts down.
+//
+// As in Chapel, each message is written as a whole, i.e. messages printed by
+// different tasks are never interleaved with each other.
+//
+// If suppressOutput is set (see config.hpp), messages are discarded before
+// they are formatted.
+
+namespace chapel {
+
+    namespace detail {
+
+        // Buffers are handed to the console once they exceed this size.
+        inline constexpr std::size_t writeln_buffer_size = 64 * 1024;
+
+        struct writeln_buffer
+        {
+            hpx::spinlock mtx;
+            std::string data;
+        };
+
+        // Return the buffer associated with the current worker thread, or
+        // nullptr if the calling thread is not an HPX worker thread.
+        writeln_buffer* get_writeln_buffer();
+
+        // Write the given batch of messages to the console.
+        void write_console(std::string const& batch);
+
+        inline void append(std::string& buffer, std::string_view value)
+        {
+            buffer.append(value.data(), value.size());
+        }
+
+        inline void append(std::string& buffer, char const* value)
+        {
+            buffer.append(value);
+        }
+
+        inline void append(std::string& buffer, std::string const& value)
+        {
+            buffer.append(value);
+        }
+
+        inline void append(std::string& buffer, string const& value)
+        {
+            buffer.append(value.data(), value.size());
+        }
+
+        inline void append(std::string& buffer, char value)
+        {
+            buffer.push_back(value);
+        }
+
+        inline void append(std::string& buffer, bool value)
+        {
+            buffer.append(value ? "true" : "false");
+        }
+
+        template <typename T>
+        void append(std::string& buffer, T const& value)
+        {
+            if constexpr (std::is_integral_v<T>)
+            {
+                char digits[24];
+                auto const result =
+                    std::to_chars(digits, digits + sizeof(digits), value);
+                buffer.append(digits, result.ptr);
+            }
+            else
+            {
+                buffer.append(hpx::util::format("{}", value));
+            }
+        }
+    }    // namespace detail
+
+    //
+    // Write all arguments followed by a newline to the console.
+    //
+    template <typename... Ts>
+    void writeln(Ts const&... ts)
+    {
+        if (suppressOutput)
+            return;
+
+        detail::writeln_buffer* buffer = detail::get_writeln_buffer();
+        if (buffer == nullptr)
+        {
+            std::string message;
+            (detail::append(message, ts), ...);
+            message.push_back('\n');
+            detail::write_console(message);
+            return;
+        }
+
+        std::string batch;
+        {
+            std::lock_guard<hpx::spinlock> l(buffer->mtx);
+
+            (detail::append(buffer->data, ts), ...);
+            buffer->data.push_back('\n');
+
+            if (buffer->data.size() < detail::writeln_buffer_size)
+                return;
+
+            std::swap(batch, buffer->data);
+        }
+
+        // never write to the console while holding the buffer lock
+        detail::write_console(batch);
+    }
+
+    //
+    // Write all messages buffered on this locality to the console.
+    //
+    void flush_writeln();
+
+    //
+    // Deterministic output for a loop over the indices [first, last): every
+    // iteration writes its messages into a slot of its own, which requires no
+    // synchronization between the tasks executing the loop. The messages are
+    // written to the console in iteration order by `flush()`, which should be
+    // invoked after the loop has finished.
+    //
+    class ordered_output
+    {
+    public:
+        ordered_output(std::int64_t first, std::int64_t last)
+          : first_(first)
+          , slots_(last > first ? last - first : 0)
+        {
+        }
+
+        ordered_output(ordered_output const&) = delete;
+        ordered_output& operator=(ordered_output const&) = delete;
+
+        ~ordered_output()
+        {
+            flush();
+        }
+
+        // Write all arguments followed by a newline as (part of) the output
+        // of iteration `idx`.
+        template <typename... Ts>
+        void writeln(std::int64_t idx, Ts const&... ts)
+        {
+            if (suppressOutput)
+                return;
+
+            std::string& slot = slots_[idx - first_];
+            (detail::append(slot, ts), ...);
+            slot.push_back('\n');
+        }
+
+        void flush()
+        {
+            std::string batch;
+            for (std::string& slot : slots_)
+            {
+                batch.append(slot);
+                std::string().swap(slot);
+
+                if (batch.size() >= detail::writeln_buffer_size)
+                {
+                    detail::write_console(batch);
+                    batch.clear();
+                }
+            }
+
+            if (!batch.empty())
+            {
+                detail::write_console(batch);
+            }
+        }
+
+    private:
+        std::int64_t first_;
+        std::vector<std::string> slots_;
+    };
+}    // namespace chapel
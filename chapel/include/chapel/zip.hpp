@@ -0,0 +1,285 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <hpx/modules/errors.hpp>
+
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/dist_array.hpp>
+#include <chapel/domain.hpp>
+#include <chapel/range.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Zippered iteration
+//
+//      forall (i, a, b) in zip(1..n, A, B) do f(i, a, b);
+//
+// is written as
+//
+//      chapel::forall(chapel::zip(chapel::range(1, n), A, B), f);
+//
+// As in Chapel, the first iterand is the leader: it determines how the
+// iterations are divided into chunks and distributed between the tasks. All
+// other iterands (the followers) yield the elements at the same positions
+// (in iteration order) as the leader, thus a zippered forall-loop is a
+// single pass over all iterands. A range, vector or local slice leads by
+// handing each task one contiguous chunk of positions, a domain leads by
+// dealing out its tiles exactly as forall(domain) does (each row of a tile
+// being a contiguous run of positions). All iterands must have the same
+// number of elements.
+//
+// Supported iterands are ranges, rectangular domains (yielding their indices
+// as std::array in row-major order), the local slices of distributed arrays
+// (local_view), and std::vector. Whole distributed arrays can't be zipped,
+// zip their local slices inside a coforall_locales instead. Iterands passed
+// as lvalues are referenced, all others are stored in the zip object.
+
+namespace chapel {
+
+    template <typename... Ts>
+    struct zip_iter
+    {
+        std::tuple<Ts...> iterands;
+    };
+
+    template <typename... Ts>
+    zip_iter<Ts...> zip(Ts&&... ts)
+    {
+        static_assert(sizeof...(Ts) != 0, "zip requires at least one iterand");
+        return zip_iter<Ts...>{std::tuple<Ts...>(std::forward<Ts>(ts)...)};
+    }
+
+    namespace detail {
+
+        // number of elements of an iterand
+        inline std::int64_t zip_size(range const& r)
+        {
+            return r.size();
+        }
+
+        template <std::size_t N>
+        std::int64_t zip_size(domain<N> const& D)
+        {
+            return D.size();
+        }
+
+        template <typename T>
+        std::int64_t zip_size(local_view<T> const& v)
+        {
+            return v.size();
+        }
+
+        template <typename T, typename Allocator>
+        std::int64_t zip_size(std::vector<T, Allocator> const& v)
+        {
+            return static_cast<std::int64_t>(v.size());
+        }
+
+        // the k'th element of an iterand
+        inline std::int64_t zip_element(range const& r, std::int64_t k)
+        {
+            return r[k];
+        }
+
+        template <typename T>
+        T& zip_element(local_view<T> const& v, std::int64_t k)
+        {
+            return v[k];
+        }
+
+        template <typename T, typename Allocator>
+        T& zip_element(std::vector<T, Allocator>& v, std::int64_t k)
+        {
+            return v[k];
+        }
+
+        template <typename T, typename Allocator>
+        T const& zip_element(std::vector<T, Allocator> const& v, std::int64_t k)
+        {
+            return v[k];
+        }
+
+        // Yields the elements of an iterand at the consecutive positions
+        // k, k + 1, ...
+        template <typename It>
+        struct zip_cursor
+        {
+            decltype(auto) operator*() const
+            {
+                return zip_element(*it, k);
+            }
+
+            void next()
+            {
+                ++k;
+            }
+
+            It* it;
+            std::int64_t k;
+        };
+
+        template <typename It>
+        zip_cursor<It> make_zip_cursor(It& it, std::int64_t k)
+        {
+            return zip_cursor<It>{&it, k};
+        }
+
+        // The index of a domain is computed from the position only once, it
+        // is then advanced one dimension at a time (row-major)
+        template <std::size_t N>
+        class domain_zip_cursor
+        {
+        public:
+            domain_zip_cursor(domain<N> const& D, std::int64_t k)
+              : D_(&D)
+            {
+                for (std::size_t d = N; d-- != 0;)
+                {
+                    range const& r = D.dim(d);
+                    pos_[d] = k % r.size();
+                    idx_[d] = r[pos_[d]];
+                    k /= r.size();
+                }
+            }
+
+            std::array<std::int64_t, N> const& operator*() const
+            {
+                return idx_;
+            }
+
+            void next()
+            {
+                for (std::size_t d = N; d-- != 0;)
+                {
+                    range const& r = D_->dim(d);
+                    if (++pos_[d] != r.size())
+                    {
+                        idx_[d] = r[pos_[d]];
+                        return;
+                    }
+                    pos_[d] = 0;
+                    idx_[d] = r[0];
+                }
+            }
+
+        private:
+            domain<N> const* D_;
+            std::array<std::int64_t, N> pos_;
+            std::array<std::int64_t, N> idx_;
+        };
+
+        template <std::size_t N>
+        domain_zip_cursor<N> make_zip_cursor(
+            domain<N> const& D, std::int64_t k)
+        {
+            return domain_zip_cursor<N>(D, k);
+        }
+
+        // Invoke f for the elements at the positions [lo, hi) of all
+        // iterands
+        template <typename F, typename... Cursors>
+        void zip_run(
+            std::int64_t lo, std::int64_t hi, F const& f, Cursors... cursors)
+        {
+            for (std::int64_t k = lo; k != hi; ++k)
+            {
+                f(*cursors...);
+                (cursors.next(), ...);
+            }
+        }
+
+        // The leader invokes body(lo, hi) for runs of consecutive positions
+        // [lo, hi) which together cover all `size` positions, one
+        // contiguous run per task unless specialized below
+        template <typename Leader, typename Body>
+        void zip_lead(Leader const&, std::int64_t size, Body const& body)
+        {
+            forall_tasks(0, size, forall_num_tasks(size),
+                [&](std::size_t, std::int64_t lo, std::int64_t hi) {
+                    body(lo, hi);
+                });
+        }
+
+        // Invoke body for every row of the tile spanning the positions
+        // [lo[d], hi[d]) along each dimension d of `D`, `base` is the
+        // position of the first index of the tile's row along dimension Dim
+        template <std::size_t Dim, std::size_t N, typename Body>
+        void zip_tile_rows(domain<N> const& D,
+            std::array<std::int64_t, N> const& lo,
+            std::array<std::int64_t, N> const& hi, std::int64_t base,
+            Body const& body)
+        {
+            if constexpr (Dim + 1 == N)
+            {
+                body(base + lo[Dim], base + hi[Dim]);
+            }
+            else
+            {
+                for (std::int64_t k = lo[Dim]; k != hi[Dim]; ++k)
+                {
+                    zip_tile_rows<Dim + 1>(
+                        D, lo, hi, (base + k) * D.dim(Dim + 1).size(), body);
+                }
+            }
+        }
+
+        template <std::size_t N, typename Body>
+        void zip_lead(domain<N> const& D, std::int64_t, Body const& body)
+        {
+            std::array<std::int64_t, N> tile;
+            tile.fill(domain_tile_size);
+
+            forall_tiles(D, tile,
+                [&](std::array<std::int64_t, N> const& lo,
+                    std::array<std::int64_t, N> const& hi) {
+                    zip_tile_rows<0>(D, lo, hi, 0, body);
+                });
+        }
+    }    // namespace detail
+
+    //
+    // Invoke f(a, b, ...) for the corresponding elements of all iterands of
+    // the zip, the equivalent of
+    //
+    //      forall (a, b, ...) in zip(A, B, ...) do f(a, b, ...);
+    //
+    // Throws hpx::exception (bad_parameter) if the iterands don't have the
+    // same number of elements.
+    //
+    template <typename... Ts, typename F>
+    void forall(zip_iter<Ts...> const& z, F const& f)
+    {
+        std::int64_t const size = detail::zip_size(std::get<0>(z.iterands));
+
+        std::apply(
+            [&](auto const&... its) {
+                if (((detail::zip_size(its) != size) || ...))
+                {
+                    HPX_THROW_EXCEPTION(hpx::error::bad_parameter,
+                        "chapel::forall",
+                        "zippered iterands have different sizes");
+                }
+            },
+            z.iterands);
+
+        detail::zip_lead(std::get<0>(z.iterands), size,
+            [&](std::int64_t lo, std::int64_t hi) {
+                std::apply(
+                    [&](auto&... its) {
+                        detail::zip_run(
+                            lo, hi, f, detail::make_zip_cursor(its, lo)...);
+                    },
+                    z.iterands);
+            });
+    }
+}    // namespace chapel
@@ -0,0 +1,60 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/collectives.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+
+#include <chapel/detail/collectives.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/locales.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+namespace chapel::detail {
+
+    namespace {
+
+        // Executed on locale #0 only
+        std::size_t allocate_collective_generation()
+        {
+            static std::atomic<std::size_t> generation(0);
+            return ++generation;
+        }
+
+        struct allocate_collective_generation_action
+          : hpx::actions::make_action<
+                decltype(&allocate_collective_generation),
+                &allocate_collective_generation,
+                allocate_collective_generation_action>::type
+        {
+        };
+    }    // namespace
+
+    hpx::collectives::communicator get_locales_communicator()
+    {
+        static hpx::collectives::communicator comm =
+            hpx::collectives::create_communicator("chapel_hpx/collectives",
+                hpx::collectives::num_sites_arg(numLocales()),
+                hpx::collectives::this_site_arg(here().id));
+        return comm;
+    }
+
+    std::size_t next_collective_generation()
+    {
+        if (here().id == 0)
+        {
+            return allocate_collective_generation();
+        }
+
+        count_comm(comm_op::execute_on);
+        return hpx::async<allocate_collective_generation_action>(
+            hpx::naming::get_id_from_locality_id(0))
+            .get();
+    }
+}    // namespace chapel::detail
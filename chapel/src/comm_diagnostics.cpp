@@ -0,0 +1,402 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/include/performance_counters.hpp>
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_combinators.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/concurrency.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/format.hpp>
+#include <hpx/modules/futures.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <chapel/comm_diagnostics.hpp>
+#include <chapel/config.hpp>
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/writeln.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace chapel {
+
+    namespace detail {
+
+        namespace {
+
+            constexpr std::size_t num_comm_ops = 4;
+
+            struct comm_state
+            {
+                // the operations initiated since the runtime started, these
+                // are exposed as the /chapel/comm/* counters
+                hpx::util::cache_aligned_data<std::atomic<std::uint64_t>>
+                    totals[num_comm_ops];
+
+                // the values of the /chapel/comm/* counters are relative to
+                // these (reset by the counter framework)
+                std::atomic<std::uint64_t> counter_bases[num_comm_ops] = {};
+
+                // the counts of the previous regions, and the values of the
+                // totals and HPX counters at the start of the current region,
+                // reading the HPX counters may suspend
+                hpx::mutex mtx;
+                bool enabled = false;
+                std::uint64_t counts[num_comm_ops] = {};
+                std::uint64_t counts_start[num_comm_ops] = {};
+                std::uint64_t parcels = 0;
+                std::uint64_t bytes = 0;
+                std::uint64_t parcels_start = 0;
+                std::uint64_t bytes_start = 0;
+            };
+
+            comm_state state;
+
+            std::uint64_t total(std::size_t op)
+            {
+                return state.totals[op].data_.load(std::memory_order_relaxed);
+            }
+
+            // The value of the counter /chapel{locality#N/total}/comm/<op>
+            template <comm_op Op>
+            std::int64_t comm_counter(bool reset)
+            {
+                auto const op = static_cast<std::size_t>(Op);
+                std::uint64_t const value = total(op);
+                std::uint64_t const base = reset ?
+                    state.counter_bases[op].exchange(value) :
+                    state.counter_bases[op].load();
+                return static_cast<std::int64_t>(value - base);
+            }
+
+            // Return the current value of the given HPX counter of this
+            // locality, or zero if it is not available (e.g. if HPX was
+            // built without networking support)
+            std::uint64_t read_counter(char const* object, char const* name)
+            {
+                std::string const counter = std::string("/") + object +
+                    "{locality#" + std::to_string(hpx::get_locality_id()) +
+                    "/total}/" + name;
+
+                try
+                {
+                    hpx::performance_counters::performance_counter c(counter);
+                    return static_cast<std::uint64_t>(
+                        c.get_value<std::int64_t>(hpx::launch::sync));
+                }
+                catch (hpx::exception const&)
+                {
+                    return 0;
+                }
+            }
+
+            std::uint64_t parcels_sent()
+            {
+                return read_counter("parcels", "count/sent");
+            }
+
+            std::uint64_t bytes_sent()
+            {
+                return read_counter("data", "count/sent");
+            }
+        }    // namespace
+
+        void count_comm(comm_op op)
+        {
+            state.totals[static_cast<std::size_t>(op)].data_.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+
+        enum class comm_command : int
+        {
+            start,
+            stop,
+            reset
+        };
+
+        void comm_diagnostics_command(int command)
+        {
+            switch (static_cast<comm_command>(command))
+            {
+            case comm_command::start:
+                startCommDiagnosticsHere();
+                break;
+
+            case comm_command::stop:
+                stopCommDiagnosticsHere();
+                break;
+
+            case comm_command::reset:
+                resetCommDiagnosticsHere();
+                break;
+            }
+        }
+
+        struct comm_diagnostics_command_action
+          : hpx::actions::make_action<decltype(&comm_diagnostics_command),
+                &comm_diagnostics_command,
+                comm_diagnostics_command_action>::type
+        {
+        };
+
+        struct get_comm_diagnostics_action
+          : hpx::actions::make_action<decltype(&getCommDiagnosticsHere),
+                &getCommDiagnosticsHere, get_comm_diagnostics_action>::type
+        {
+        };
+
+        // Execute the command on all locales and wait for it to finish
+        void comm_diagnostics_all(comm_command command)
+        {
+            std::vector<hpx::future<void>> results;
+            results.reserve(numLocales());
+
+            for (std::uint32_t loc = 0; loc != numLocales(); ++loc)
+            {
+                if (loc == here().id)
+                {
+                    comm_diagnostics_command(static_cast<int>(command));
+                    continue;
+                }
+
+                results.push_back(hpx::async<comm_diagnostics_command_action>(
+                    hpx::naming::get_id_from_locality_id(loc),
+                    static_cast<int>(command)));
+            }
+
+            hpx::wait_all(results);
+            for (auto& result : results)
+            {
+                result.get();    // rethrow exceptions
+            }
+        }
+
+        std::string format_comm_diagnostics(
+            std::uint32_t loc, commDiagnostics const& d)
+        {
+            return hpx::util::format(
+                "| {:6} | {:10} | {:10} | {:10} | {:13} | {:10} | {:12} |\n",
+                loc, d.get, d.put, d.execute_on, d.execute_on_nb, d.parcels,
+                d.bytes);
+        }
+
+        std::string comm_diagnostics_header()
+        {
+            return "| locale |        get |        put | execute_on | "
+                   "execute_on_nb |    parcels |        bytes |\n";
+        }
+
+        // Make the counts available to HPX's performance counter framework,
+        // e.g. --hpx:print-counter=/chapel{locality#*/total}/comm/get
+        void install_comm_counters()
+        {
+            using hpx::performance_counters::counter_type;
+            using hpx::performance_counters::install_counter_type;
+
+            install_counter_type("/chapel/comm/get",
+                &comm_counter<comm_op::get>,
+                "returns the number of remote element reads initiated by "
+                "the locale",
+                "", counter_type::monotonically_increasing);
+            install_counter_type("/chapel/comm/put",
+                &comm_counter<comm_op::put>,
+                "returns the number of remote element writes initiated by "
+                "the locale",
+                "", counter_type::monotonically_increasing);
+            install_counter_type("/chapel/comm/execute_on",
+                &comm_counter<comm_op::execute_on>,
+                "returns the number of blocking remote invocations "
+                "(including collective operations) initiated by the locale",
+                "", counter_type::monotonically_increasing);
+            install_counter_type("/chapel/comm/execute_on_nb",
+                &comm_counter<comm_op::execute_on_nb>,
+                "returns the number of tasks created on other locales by "
+                "the locale",
+                "", counter_type::monotonically_increasing);
+        }
+
+        // Collect the diagnostics of the whole run if requested on the
+        // command line (see printCommDiagnostics), each locale prints its
+        // own counts before the runtime shuts down
+        void start_comm_diagnostics_at_startup()
+        {
+            install_comm_counters();
+
+            if (printCommDiagnostics)
+            {
+                startCommDiagnosticsHere();
+            }
+        }
+
+        void print_comm_diagnostics_at_shutdown()
+        {
+            if (printCommDiagnostics)
+            {
+                stopCommDiagnosticsHere();
+                write_console(comm_diagnostics_header() +
+                    format_comm_diagnostics(
+                        hpx::get_locality_id(), getCommDiagnosticsHere()));
+            }
+        }
+
+        struct register_comm_diagnostics
+        {
+            register_comm_diagnostics()
+            {
+                hpx::register_startup_function(
+                    &start_comm_diagnostics_at_startup);
+                hpx::register_pre_shutdown_function(
+                    &print_comm_diagnostics_at_shutdown);
+            }
+        };
+
+        register_comm_diagnostics comm_diagnostics_at_startup;
+    }    // namespace detail
+
+    void startCommDiagnosticsHere()
+    {
+        std::lock_guard<hpx::mutex> l(detail::state.mtx);
+        if (detail::state.enabled)
+            return;
+
+        for (std::size_t op = 0; op != detail::num_comm_ops; ++op)
+        {
+            detail::state.counts_start[op] = detail::total(op);
+        }
+        detail::state.parcels_start = detail::parcels_sent();
+        detail::state.bytes_start = detail::bytes_sent();
+        detail::state.enabled = true;
+    }
+
+    void stopCommDiagnosticsHere()
+    {
+        std::lock_guard<hpx::mutex> l(detail::state.mtx);
+        if (!detail::state.enabled)
+            return;
+
+        detail::state.enabled = false;
+        for (std::size_t op = 0; op != detail::num_comm_ops; ++op)
+        {
+            detail::state.counts[op] +=
+                detail::total(op) - detail::state.counts_start[op];
+        }
+        detail::state.parcels +=
+            detail::parcels_sent() - detail::state.parcels_start;
+        detail::state.bytes += detail::bytes_sent() - detail::state.bytes_start;
+    }
+
+    void resetCommDiagnosticsHere()
+    {
+        std::lock_guard<hpx::mutex> l(detail::state.mtx);
+        for (std::size_t op = 0; op != detail::num_comm_ops; ++op)
+        {
+            detail::state.counts[op] = 0;
+            detail::state.counts_start[op] = detail::total(op);
+        }
+
+        detail::state.parcels = 0;
+        detail::state.bytes = 0;
+        if (detail::state.enabled)
+        {
+            detail::state.parcels_start = detail::parcels_sent();
+            detail::state.bytes_start = detail::bytes_sent();
+        }
+    }
+
+    commDiagnostics getCommDiagnosticsHere()
+    {
+        std::lock_guard<hpx::mutex> l(detail::state.mtx);
+
+        auto count = [](detail::comm_op op) {
+            auto const i = static_cast<std::size_t>(op);
+            std::uint64_t result = detail::state.counts[i];
+            if (detail::state.enabled)
+            {
+                result += detail::total(i) - detail::state.counts_start[i];
+            }
+            return result;
+        };
+
+        commDiagnostics result;
+        result.get = count(detail::comm_op::get);
+        result.put = count(detail::comm_op::put);
+        result.execute_on = count(detail::comm_op::execute_on);
+        result.execute_on_nb = count(detail::comm_op::execute_on_nb);
+
+        result.parcels = detail::state.parcels;
+        result.bytes = detail::state.bytes;
+        if (detail::state.enabled)
+        {
+            result.parcels +=
+                detail::parcels_sent() - detail::state.parcels_start;
+            result.bytes += detail::bytes_sent() - detail::state.bytes_start;
+        }
+        return result;
+    }
+
+    void startCommDiagnostics()
+    {
+        detail::comm_diagnostics_all(detail::comm_command::start);
+    }
+
+    void stopCommDiagnostics()
+    {
+        detail::comm_diagnostics_all(detail::comm_command::stop);
+    }
+
+    void resetCommDiagnostics()
+    {
+        detail::comm_diagnostics_all(detail::comm_command::reset);
+    }
+
+    std::vector<commDiagnostics> getCommDiagnostics()
+    {
+        std::vector<hpx::future<commDiagnostics>> results;
+        results.reserve(numLocales());
+
+        for (std::uint32_t loc = 0; loc != numLocales(); ++loc)
+        {
+            if (loc == here().id)
+            {
+                results.push_back(
+                    hpx::make_ready_future(getCommDiagnosticsHere()));
+                continue;
+            }
+
+            results.push_back(hpx::async<detail::get_comm_diagnostics_action>(
+                hpx::naming::get_id_from_locality_id(loc)));
+        }
+
+        std::vector<commDiagnostics> diagnostics;
+        diagnostics.reserve(results.size());
+        for (auto& result : results)
+        {
+            diagnostics.push_back(result.get());
+        }
+        return diagnostics;
+    }
+
+    void printCommDiagnosticsTable()
+    {
+        std::vector<commDiagnostics> const diagnostics = getCommDiagnostics();
+
+        std::string table = detail::comm_diagnostics_header();
+        for (std::uint32_t loc = 0; loc != diagnostics.size(); ++loc)
+        {
+            table += detail::format_comm_diagnostics(loc, diagnostics[loc]);
+        }
+        detail::write_console(table);
+    }
+}    // namespace chapel
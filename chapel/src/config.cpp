@@ -0,0 +1,111 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/modules/program_options.hpp>
+
+#include <chapel/config.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chapel {
+
+#if !defined(CHAPEL_PARAM_spawnTreeArity)
+    std::uint32_t spawnTreeArity = 8;
+#endif
+#if !defined(CHAPEL_PARAM_dstBuffSize)
+    std::size_t dstBuffSize = 4096;
+#endif
+#if !defined(CHAPEL_PARAM_srcBuffSize)
+    std::size_t srcBuffSize = 4096;
+#endif
+#if !defined(CHAPEL_PARAM_dataParTasksPerLocale)
+    std::uint32_t dataParTasksPerLocale = 0;
+#endif
+#if !defined(CHAPEL_PARAM_dataParIgnoreRunningTasks)
+    bool dataParIgnoreRunningTasks = false;
+#endif
+#if !defined(CHAPEL_PARAM_dataParMinGranularity)
+    std::int64_t dataParMinGranularity = 1;
+#endif
+#if !defined(CHAPEL_PARAM_suppressOutput)
+    bool suppressOutput = false;
+#endif
+#if !defined(CHAPEL_PARAM_printCommDiagnostics)
+    bool printCommDiagnostics = false;
+#endif
+#if !defined(CHAPEL_PARAM_traceLoops)
+    bool traceLoops = false;
+#endif
+#if !defined(CHAPEL_PARAM_traceBufferSize)
+    std::size_t traceBufferSize = 65536;
+#endif
+
+    hpx::program_options::options_description get_config_variables()
+    {
+        hpx::program_options::options_description options(
+            "Chapel runtime options");
+
+        // clang-format off
+        options.add_options()
+#if !defined(CHAPEL_PARAM_spawnTreeArity)
+            ("spawnTreeArity",
+                hpx::program_options::value<std::uint32_t>(&spawnTreeArity),
+                R"(config const spawnTreeArity = 8)")
+#endif
+#if !defined(CHAPEL_PARAM_dstBuffSize)
+            ("dstBuffSize",
+                hpx::program_options::value<std::size_t>(&dstBuffSize),
+                R"(config const dstBuffSize = 4096)")
+#endif
+#if !defined(CHAPEL_PARAM_srcBuffSize)
+            ("srcBuffSize",
+                hpx::program_options::value<std::size_t>(&srcBuffSize),
+                R"(config const srcBuffSize = 4096)")
+#endif
+#if !defined(CHAPEL_PARAM_dataParTasksPerLocale)
+            ("dataParTasksPerLocale",
+                hpx::program_options::value<std::uint32_t>(
+                    &dataParTasksPerLocale),
+                R"(config const dataParTasksPerLocale = 0)")
+#endif
+#if !defined(CHAPEL_PARAM_dataParIgnoreRunningTasks)
+            ("dataParIgnoreRunningTasks",
+                hpx::program_options::value<bool>(&dataParIgnoreRunningTasks),
+                R"(config const dataParIgnoreRunningTasks = false)")
+#endif
+#if !defined(CHAPEL_PARAM_dataParMinGranularity)
+            ("dataParMinGranularity",
+                hpx::program_options::value<std::int64_t>(
+                    &dataParMinGranularity),
+                R"(config const dataParMinGranularity = 1)")
+#endif
+#if !defined(CHAPEL_PARAM_suppressOutput)
+            ("suppressOutput",
+                hpx::program_options::value<bool>(&suppressOutput),
+                R"(config const suppressOutput = false)")
+#endif
+#if !defined(CHAPEL_PARAM_printCommDiagnostics)
+            ("printCommDiagnostics",
+                hpx::program_options::value<bool>(&printCommDiagnostics),
+                R"(config const printCommDiagnostics = false)")
+#endif
+#if !defined(CHAPEL_PARAM_traceLoops)
+            ("traceLoops",
+                hpx::program_options::value<bool>(&traceLoops),
+                R"(config const traceLoops = false)")
+#endif
+#if !defined(CHAPEL_PARAM_traceBufferSize)
+            ("traceBufferSize",
+                hpx::program_options::value<std::size_t>(&traceBufferSize),
+                R"(config const traceBufferSize = 65536)")
+#endif
+        ;
+        // clang-format on
+
+        return options;
+    }
+}    // namespace chapel
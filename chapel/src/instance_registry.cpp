@@ -0,0 +1,211 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/assert.hpp>
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <chapel/detail/comm_diagnostics.hpp>
+#include <chapel/detail/instance_registry.hpp>
+#include <chapel/locales.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace chapel::detail {
+
+    namespace {
+
+        // The table is an array of blocks of slots, blocks are allocated
+        // on first use and are never moved, thus readers don't need to
+        // synchronize with writers registering other instances.
+        constexpr std::size_t block_size = 4096;
+        constexpr std::size_t max_blocks = 4096;
+
+        struct slot
+        {
+            std::atomic<void*> ptr{nullptr};
+            std::shared_ptr<void> instance;
+        };
+
+        struct block
+        {
+            slot slots[block_size];
+        };
+
+        struct instance_table
+        {
+            ~instance_table()
+            {
+                for (auto& b : blocks)
+                {
+                    delete b.load(std::memory_order_relaxed);
+                }
+            }
+
+            hpx::spinlock mtx;
+            std::atomic<block*> blocks[max_blocks] = {};
+        };
+
+        instance_table instances;
+
+        slot* find_slot(std::uint64_t id)
+        {
+            HPX_ASSERT(id / block_size < max_blocks);
+            block* b = instances.blocks[id / block_size].load(
+                std::memory_order_acquire);
+            return b != nullptr ? &b->slots[id % block_size] : nullptr;
+        }
+
+        // The IDs are handed out by locale #0. Released IDs are reused
+        // before new ones are drawn, so the IDs in use (and the size of the
+        // tables) are bounded by the number of live distributed objects.
+        struct instance_ids
+        {
+            hpx::spinlock mtx;
+            std::uint64_t count = 0;
+            std::vector<std::uint64_t> released;
+        };
+
+        instance_ids ids;
+
+        // Executed on locale #0 only
+        std::uint64_t allocate_instance_id()
+        {
+            std::lock_guard<hpx::spinlock> l(ids.mtx);
+
+            if (!ids.released.empty())
+            {
+                std::uint64_t const id = ids.released.back();
+                ids.released.pop_back();
+                return id;
+            }
+
+            if ((ids.count + 1) / block_size >= max_blocks)
+            {
+                HPX_THROW_EXCEPTION(hpx::error::out_of_memory,
+                    "chapel::detail::next_instance_id",
+                    "too many distributed objects are alive");
+            }
+            return ++ids.count;
+        }
+
+        struct allocate_instance_id_action
+          : hpx::actions::make_action<decltype(&allocate_instance_id),
+                &allocate_instance_id, allocate_instance_id_action>::type
+        {
+        };
+
+        // Executed on locale #0 only
+        void free_instance_id(std::uint64_t id)
+        {
+            std::lock_guard<hpx::spinlock> l(ids.mtx);
+
+            HPX_ASSERT(id != 0 && id <= ids.count);
+            ids.released.push_back(id);
+        }
+
+        struct free_instance_id_action
+          : hpx::actions::make_action<decltype(&free_instance_id),
+                &free_instance_id, free_instance_id_action>::type
+        {
+        };
+    }    // namespace
+
+    std::uint64_t next_instance_id()
+    {
+        if (here().id == 0)
+        {
+            return allocate_instance_id();
+        }
+
+        count_comm(comm_op::execute_on);
+        return hpx::async<allocate_instance_id_action>(
+            hpx::naming::get_id_from_locality_id(0))
+            .get();
+    }
+
+    void release_instance_id(std::uint64_t id)
+    {
+        if (here().id == 0)
+        {
+            free_instance_id(id);
+            return;
+        }
+
+        count_comm(comm_op::execute_on);
+        hpx::async<free_instance_id_action>(
+            hpx::naming::get_id_from_locality_id(0), id)
+            .get();
+    }
+
+    void register_instance(std::uint64_t id, std::shared_ptr<void> instance)
+    {
+        HPX_ASSERT(id / block_size < max_blocks);
+
+        std::lock_guard<hpx::spinlock> l(instances.mtx);
+
+        auto& b = instances.blocks[id / block_size];
+        if (b.load(std::memory_order_relaxed) == nullptr)
+        {
+            b.store(new block, std::memory_order_release);
+        }
+
+        slot& s = b.load(std::memory_order_relaxed)->slots[id % block_size];
+        s.instance = std::move(instance);
+        s.ptr.store(s.instance.get(), std::memory_order_release);
+    }
+
+    void unregister_instance(std::uint64_t id)
+    {
+        std::shared_ptr<void> instance;
+        {
+            std::lock_guard<hpx::spinlock> l(instances.mtx);
+
+            slot* s = find_slot(id);
+            if (s == nullptr)
+                return;
+
+            s->ptr.store(nullptr, std::memory_order_relaxed);
+            instance = std::move(s->instance);
+        }
+        // the instance is destroyed outside of the lock
+    }
+
+    void report_destructor_failure(char const* type, char const* action,
+        std::exception_ptr const& e) noexcept
+    {
+        try
+        {
+            std::cerr << type << ": failed to " << action << ": "
+                      << hpx::get_error_what(e) << std::endl;
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void* get_instance(std::uint64_t id)
+    {
+        slot* s = find_slot(id);
+        HPX_ASSERT(s != nullptr);
+
+        void* instance =
+            s != nullptr ? s->ptr.load(std::memory_order_acquire) : nullptr;
+        HPX_ASSERT(instance != nullptr);
+        return instance;
+    }
+}    // namespace chapel::detail
@@ -0,0 +1,127 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/assert.hpp>
+#include <hpx/modules/collectives.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/resource_partitioner.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/topology.hpp>
+
+#include <chapel/locales.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace chapel {
+
+    namespace detail {
+
+        std::vector<locale> locales;
+        std::uint32_t here_id = 0;
+        std::vector<std::uint32_t> worker_numa_domains;
+
+        // One sublocale per NUMA domain hosting at least one of the worker
+        // threads of this locality, records the NUMA domain of every worker
+        std::vector<sublocale> numa_sublocales()
+        {
+            auto const& topo = hpx::threads::create_topology();
+            auto& rp = hpx::resource::get_partitioner();
+
+            std::map<std::uint32_t, std::size_t> threads_per_domain;
+            std::size_t const num_threads = hpx::get_os_thread_count();
+            for (std::size_t t = 0; t != num_threads; ++t)
+            {
+                std::size_t domain =
+                    topo.get_numa_node_number(rp.get_pu_num(t));
+                if (domain == std::size_t(-1))
+                {
+                    domain = 0;    // no NUMA information available
+                }
+                ++threads_per_domain[static_cast<std::uint32_t>(domain)];
+                worker_numa_domains.push_back(
+                    static_cast<std::uint32_t>(domain));
+            }
+
+            std::vector<sublocale> children;
+            children.reserve(threads_per_domain.size());
+            for (auto const& [domain, count] : threads_per_domain)
+            {
+                sublocale child;
+                child.id = static_cast<std::uint32_t>(children.size());
+                child.numaDomain = domain;
+                child.maxTaskPar = count;
+                children.push_back(child);
+            }
+            return children;
+        }
+
+        // Executed on every locality before hpx_main is run
+        void init_locales()
+        {
+            locale here_locale;
+            here_locale.id = hpx::get_locality_id();
+            here_locale.name = hpx::get_locality_name();
+            here_locale.maxTaskPar = hpx::get_os_thread_count();
+            here_locale.children = numa_sublocales();
+
+            here_id = here_locale.id;
+
+            std::uint32_t const num_locales =
+                hpx::get_num_localities(hpx::launch::sync);
+            if (num_locales == 1)
+            {
+                locales.push_back(std::move(here_locale));
+                return;
+            }
+
+            locales = hpx::collectives::all_gather("chapel_hpx/locales",
+                std::move(here_locale),
+                hpx::collectives::num_sites_arg(num_locales),
+                hpx::collectives::this_site_arg(here_id))
+                          .get();
+        }
+
+        struct register_init_locales
+        {
+            register_init_locales()
+            {
+                hpx::register_startup_function(&init_locales);
+            }
+        };
+
+        register_init_locales init_locales_at_startup;
+    }    // namespace detail
+
+    std::vector<locale> const& Locales()
+    {
+        return detail::locales;
+    }
+
+    std::uint32_t numLocales()
+    {
+        return static_cast<std::uint32_t>(detail::locales.size());
+    }
+
+    locale const& here()
+    {
+        HPX_ASSERT(detail::here_id < detail::locales.size());
+        return detail::locales[detail::here_id];
+    }
+
+    namespace detail {
+
+        std::uint32_t numa_domain_of_worker(std::size_t worker)
+        {
+            return worker < worker_numa_domains.size() ?
+                worker_numa_domains[worker] :
+                0;
+        }
+    }    // namespace detail
+}    // namespace chapel
@@ -0,0 +1,362 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/synchronization.hpp>
+#include <hpx/modules/threading_base.hpp>
+#include <hpx/modules/timing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/detail/loop_trace.hpp>
+#include <chapel/detail/task_counter.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/loop_trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace chapel {
+
+    namespace detail {
+
+        namespace {
+
+            struct trace_slot
+            {
+                hpx::spinlock mtx;
+                bool valid = false;
+                trace_event event;
+            };
+
+            struct trace_buffer
+            {
+                explicit trace_buffer(std::size_t size)
+                  : size((std::max)(size, std::size_t(1)))
+                  , slots(new trace_slot[this->size])
+                {
+                }
+
+                std::size_t const size;
+                std::unique_ptr<trace_slot[]> slots;
+                std::atomic<std::uint64_t> next{0};
+            };
+
+            trace_buffer& get_trace_buffer()
+            {
+                static trace_buffer buffer(traceBufferSize);
+                return buffer;
+            }
+
+            std::atomic<std::uint64_t> loop_ids(0);
+
+            // The name given by the loop_name of the calling task (or of the
+            // task that created it), or its annotation (description)
+            std::string loop_name()
+            {
+                if (hpx::threads::get_self_ptr() == nullptr)
+                {
+                    return "<unknown>";
+                }
+
+                char const* name = current_task_context().loop_name;
+                if (name != nullptr)
+                {
+                    return name;
+                }
+
+                return hpx::threads::as_string(
+                    hpx::threads::get_thread_description(
+                        hpx::threads::get_self_id()));
+            }
+
+            template <typename T>
+            void atomic_max(std::atomic<T>& value, T v)
+            {
+                T current = value.load(std::memory_order_relaxed);
+                while (current < v &&
+                    !value.compare_exchange_weak(
+                        current, v, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            template <typename T>
+            void atomic_min(std::atomic<T>& value, T v)
+            {
+                T current = value.load(std::memory_order_relaxed);
+                while (current > v &&
+                    !value.compare_exchange_weak(
+                        current, v, std::memory_order_relaxed))
+                {
+                }
+            }
+
+#if defined(HPX_HAVE_APEX)
+            void sample_loop_statistics(trace_event const& e)
+            {
+                std::string const prefix =
+                    std::string("chapel/") + e.name + "/";
+
+                hpx::util::external_timer::sample_value(
+                    prefix + "wall_ns", static_cast<double>(e.end - e.start));
+                hpx::util::external_timer::sample_value(
+                    prefix + "busy_ns", static_cast<double>(e.busy));
+                hpx::util::external_timer::sample_value(
+                    prefix + "max_task_ns", static_cast<double>(e.max_busy));
+                hpx::util::external_timer::sample_value(
+                    prefix + "tasks", static_cast<double>(e.tasks));
+                hpx::util::external_timer::sample_value(
+                    prefix + "misplaced", static_cast<double>(e.misplaced));
+            }
+#endif
+
+            void write_json_string(std::ostream& os, char const* s)
+            {
+                os << '"';
+                for (; *s != '\0'; ++s)
+                {
+                    if (*s == '"' || *s == '\\')
+                    {
+                        os << '\\';
+                    }
+                    os << (static_cast<unsigned char>(*s) < 0x20 ? ' ' : *s);
+                }
+                os << '"';
+            }
+        }    // namespace
+
+        void record_trace_event(trace_event const& e)
+        {
+            trace_buffer& buffer = get_trace_buffer();
+            std::uint64_t const i =
+                buffer.next.fetch_add(1, std::memory_order_relaxed);
+            trace_slot& slot = buffer.slots[i % buffer.size];
+
+            std::lock_guard<hpx::spinlock> l(slot.mtx);
+            slot.event = e;
+            slot.valid = true;
+        }
+
+        void loop_trace::start(
+            loop_kind kind, std::int64_t iterations, std::size_t tasks)
+        {
+            loop_.loop = ++loop_ids;
+            loop_.kind = kind;
+            loop_.iterations = iterations;
+            loop_.tasks = tasks;
+
+            std::string const name = loop_name();
+            name.copy(loop_.name, sizeof(loop_.name) - 1);
+
+            loop_.start = hpx::chrono::high_resolution_clock::now();
+        }
+
+        void loop_trace::task_done(std::uint64_t start, std::int64_t iterations,
+            std::uint32_t numa_domain)
+        {
+            trace_event task;
+            task.end = hpx::chrono::high_resolution_clock::now();
+            task.start = start;
+            task.loop = loop_.loop;
+            task.kind = loop_.kind;
+            task.worker =
+                static_cast<std::uint32_t>(hpx::get_worker_thread_num());
+            task.iterations = iterations;
+
+            std::uint64_t const busy = task.end - task.start;
+            busy_.fetch_add(busy, std::memory_order_relaxed);
+            atomic_max(max_busy_, busy);
+            atomic_min(min_chunk_, iterations);
+            atomic_max(max_chunk_, iterations);
+            if (numa_domain != not_placed &&
+                numa_domain_of_worker(task.worker) != numa_domain)
+            {
+                misplaced_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            record_trace_event(task);
+        }
+
+        void loop_trace::finish()
+        {
+            loop_.end = hpx::chrono::high_resolution_clock::now();
+            loop_.busy = busy_.load(std::memory_order_relaxed);
+            loop_.max_busy = max_busy_.load(std::memory_order_relaxed);
+            loop_.min_chunk = (std::min)(
+                min_chunk_.load(std::memory_order_relaxed), loop_.iterations);
+            loop_.max_chunk = max_chunk_.load(std::memory_order_relaxed);
+            loop_.misplaced = misplaced_.load(std::memory_order_relaxed);
+
+            record_trace_event(loop_);
+
+#if defined(HPX_HAVE_APEX)
+            sample_loop_statistics(loop_);
+#endif
+        }
+
+        // Every locale writes its trace when the runtime shuts down
+        void write_loop_trace_at_shutdown()
+        {
+            if (traceLoops)
+            {
+                std::ofstream os("loop-trace." +
+                    std::to_string(hpx::get_locality_id()) + ".json");
+                write_loop_trace(os);
+            }
+        }
+
+        struct register_write_loop_trace
+        {
+            register_write_loop_trace()
+            {
+                hpx::register_pre_shutdown_function(
+                    &write_loop_trace_at_shutdown);
+            }
+        };
+
+        register_write_loop_trace loop_trace_at_shutdown;
+    }    // namespace detail
+
+    loop_name::loop_name(char const* name)
+      : active_(traceLoops && hpx::threads::get_self_ptr() != nullptr)
+    {
+        if (active_)
+        {
+            context_ = detail::current_task_context();
+            context_.loop_name = name;
+            previous_ = detail::set_task_context(&context_);
+        }
+    }
+
+    loop_name::~loop_name()
+    {
+        if (active_)
+        {
+            detail::set_task_context(previous_);
+        }
+    }
+
+    void write_loop_trace(std::ostream& os)
+    {
+        detail::trace_buffer& buffer = detail::get_trace_buffer();
+
+        std::vector<detail::trace_event> events;
+        events.reserve(buffer.size);
+        for (std::size_t i = 0; i != buffer.size; ++i)
+        {
+            detail::trace_slot& slot = buffer.slots[i];
+
+            std::lock_guard<hpx::spinlock> l(slot.mtx);
+            if (slot.valid)
+            {
+                events.push_back(slot.event);
+            }
+        }
+
+        // the names of the loops, tasks are named after their loop
+        std::map<std::uint64_t, char const*> names;
+        for (detail::trace_event const& e : events)
+        {
+            if (e.worker == detail::trace_event::loop_record)
+            {
+                names[e.loop] = e.name;
+            }
+        }
+
+        std::uint32_t const pid = hpx::get_locality_id();
+        std::size_t const workers = hpx::get_os_thread_count();
+
+        // timestamps are given in microseconds
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+
+        out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+
+        // name the threads: one per worker, and one showing the loops
+        char const* sep = "";
+        for (std::size_t t = 0; t <= workers; ++t)
+        {
+            out << sep << "{\"name\": \"thread_name\", \"ph\": \"M\""
+               << ", \"pid\": " << pid << ", \"tid\": " << t
+               << ", \"args\": {\"name\": \"";
+            if (t == workers)
+                out << "loops";
+            else
+                out << "worker " << t;
+            out << "\"}}";
+            sep = ",\n";
+        }
+
+        for (detail::trace_event const& e : events)
+        {
+            bool const is_loop = e.worker == detail::trace_event::loop_record;
+
+            auto const it = names.find(e.loop);
+            std::string const name = it != names.end() ?
+                std::string(it->second) :
+                "loop " + std::to_string(e.loop);
+
+            out << sep << "{\"name\": ";
+            detail::write_json_string(out, name.c_str());
+            out << ", \"cat\": \""
+               << (e.kind == detail::loop_kind::forall ? "forall" :
+                                                          "coforall")
+               << "\", \"ph\": \"X\", \"ts\": "
+               << static_cast<double>(e.start) / 1000.0
+               << ", \"dur\": " << static_cast<double>(e.end - e.start) / 1000.0
+               << ", \"pid\": " << pid
+               << ", \"tid\": " << (is_loop ? workers : e.worker)
+               << ", \"args\": {\"loop\": " << e.loop
+               << ", \"iterations\": " << e.iterations;
+
+            if (is_loop)
+            {
+                // the workers that could have executed the tasks were idle
+                // for the remainder of the loop
+                std::uint64_t const wall = e.end - e.start;
+                std::uint64_t const active = (std::min)(
+                    static_cast<std::uint64_t>(workers), e.tasks) * wall;
+
+                out << ", \"tasks\": " << e.tasks
+                   << ", \"min_chunk\": " << e.min_chunk
+                   << ", \"max_chunk\": " << e.max_chunk
+                   << ", \"busy_ns\": " << e.busy << ", \"idle_ns\": "
+                   << (active > e.busy ? active - e.busy : 0)
+                   << ", \"max_task_ns\": " << e.max_busy
+                   << ", \"misplaced\": " << e.misplaced;
+            }
+            out << "}}";
+            sep = ",\n";
+        }
+
+        out << "\n]}\n";
+
+        os << out.str();
+    }
+
+    void clear_loop_trace()
+    {
+        detail::trace_buffer& buffer = detail::get_trace_buffer();
+        for (std::size_t i = 0; i != buffer.size; ++i)
+        {
+            detail::trace_slot& slot = buffer.slots[i];
+
+            std::lock_guard<hpx::spinlock> l(slot.mtx);
+            slot.valid = false;
+        }
+    }
+}    // namespace chapel
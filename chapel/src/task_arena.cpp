@@ -0,0 +1,107 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <chapel/task_arena.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace chapel {
+
+    namespace {
+
+        // Every worker (OS) thread keeps a few blocks around for the next
+        // arena. The cache is never accessed across a suspension point of
+        // a task, which makes it safe to be thread_local even though HPX
+        // threads may migrate between worker threads.
+        constexpr std::size_t max_cached_blocks = 16;
+
+        struct block_cache
+        {
+            ~block_cache()
+            {
+                while (count != 0)
+                {
+                    ::operator delete(blocks[--count]);
+                }
+            }
+
+            void* blocks[max_cached_blocks];
+            std::size_t count = 0;
+        };
+
+        thread_local block_cache cache;
+
+        void* acquire_block()
+        {
+            if (cache.count != 0)
+            {
+                return cache.blocks[--cache.count];
+            }
+            return ::operator new(task_arena::arena_block_size);
+        }
+
+        void release_block(void* p)
+        {
+            if (cache.count != max_cached_blocks)
+            {
+                cache.blocks[cache.count++] = p;
+                return;
+            }
+            ::operator delete(p);
+        }
+
+        // the header of a block is followed by the memory handed out
+        constexpr std::size_t header_size = alignof(std::max_align_t);
+
+        std::uintptr_t align(std::uintptr_t p, std::size_t alignment)
+        {
+            return (p + alignment - 1) & ~std::uintptr_t(alignment - 1);
+        }
+    }    // namespace
+
+    void* task_arena::allocate_slow(std::size_t size, std::size_t alignment)
+    {
+        static_assert(sizeof(block) <= header_size);
+
+        if (header_size + size + alignment > arena_block_size)
+        {
+            void* p = ::operator new(header_size + size + alignment);
+            large_ = new (p) block{large_};
+            return reinterpret_cast<void*>(align(
+                reinterpret_cast<std::uintptr_t>(p) + header_size, alignment));
+        }
+
+        void* p = acquire_block();
+        blocks_ = new (p) block{blocks_};
+
+        current_ = static_cast<char*>(p) + header_size;
+        end_ = reinterpret_cast<std::uintptr_t>(p) + arena_block_size;
+
+        return allocate(size, alignment);
+    }
+
+    void task_arena::reset()
+    {
+        while (blocks_ != nullptr)
+        {
+            block* next = blocks_->next;
+            release_block(blocks_);
+            blocks_ = next;
+        }
+
+        while (large_ != nullptr)
+        {
+            block* next = large_->next;
+            ::operator delete(large_);
+            large_ = next;
+        }
+
+        current_ = nullptr;
+        end_ = 0;
+    }
+}    // namespace chapel
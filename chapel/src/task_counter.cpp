@@ -0,0 +1,116 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/synchronization.hpp>
+#include <hpx/modules/threading_base.hpp>
+
+#include <chapel/detail/task_counter.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+namespace chapel::detail {
+
+    void task_counter::done()
+    {
+        // fast path: this is not the last task
+        std::int64_t count = count_.load(std::memory_order_relaxed);
+        while (count > 1)
+        {
+            if (count_.compare_exchange_weak(
+                    count, count - 1, std::memory_order_acq_rel))
+            {
+                return;
+            }
+        }
+
+        std::lock_guard<hpx::spinlock> l(mtx_);
+        if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            cv_.notify_all();
+        }
+    }
+
+    void task_counter::error(std::exception_ptr e)
+    {
+        std::lock_guard<hpx::spinlock> l(mtx_);
+        errors_.add(std::move(e));
+    }
+
+    void task_counter::wait()
+    {
+        std::unique_lock<hpx::spinlock> l(mtx_);
+        cv_.wait(
+            l, [&] { return count_.load(std::memory_order_acquire) == 0; });
+
+        if (errors_.size() != 0)
+        {
+            hpx::exception_list errors = std::move(errors_);
+            errors_ = hpx::exception_list();
+            throw errors;
+        }
+    }
+
+    // The context of a task is stored as the user data of its HPX thread.
+    // Code that is not run by an HPX thread has no context.
+    task_context current_task_context()
+    {
+        if (hpx::threads::get_self_ptr() == nullptr)
+        {
+            return task_context();
+        }
+
+        auto const* context = reinterpret_cast<task_context const*>(
+            hpx::threads::get_thread_data(hpx::threads::get_self_id()));
+        return context != nullptr ? *context : task_context();
+    }
+
+    task_context const* set_task_context(task_context const* context)
+    {
+        if (hpx::threads::get_self_ptr() == nullptr)
+        {
+            return nullptr;
+        }
+
+        return reinterpret_cast<task_context const*>(
+            hpx::threads::set_thread_data(hpx::threads::get_self_id(),
+                reinterpret_cast<std::size_t>(context)));
+    }
+
+    task_counter& root_task_scope()
+    {
+        static task_counter root;
+        return root;
+    }
+
+    // Tasks that do not belong to any sync block have to finish before
+    // the runtime is shut down
+    void wait_for_root_tasks()
+    {
+        root_task_scope().wait();
+    }
+
+    struct register_wait_for_root_tasks
+    {
+        register_wait_for_root_tasks()
+        {
+            hpx::register_pre_shutdown_function(&wait_for_root_tasks);
+        }
+    };
+
+    register_wait_for_root_tasks wait_for_root_tasks_at_shutdown;
+
+    task_counter& task_scope()
+    {
+        task_counter* scope = get_task_scope();
+        return scope != nullptr ? *scope : root_task_scope();
+    }
+}    // namespace chapel::detail
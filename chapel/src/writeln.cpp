@@ -0,0 +1,78 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <hpx/iostream.hpp>
+#include <hpx/modules/concurrency.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/synchronization.hpp>
+
+#include <chapel/writeln.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace chapel {
+
+    namespace detail {
+
+        using writeln_buffers =
+            std::vector<hpx::util::cache_aligned_data<writeln_buffer>>;
+
+        writeln_buffers& get_writeln_buffers()
+        {
+            static writeln_buffers buffers(hpx::get_os_thread_count());
+            return buffers;
+        }
+
+        writeln_buffer* get_writeln_buffer()
+        {
+            std::size_t const worker = hpx::get_worker_thread_num();
+
+            writeln_buffers& buffers = get_writeln_buffers();
+            if (worker >= buffers.size())
+            {
+                return nullptr;
+            }
+            return &buffers[worker].data_;
+        }
+
+        void write_console(std::string const& batch)
+        {
+            hpx::cout << batch << hpx::flush;
+        }
+
+        // make sure that no output is lost when the runtime shuts down
+        struct register_flush_writeln
+        {
+            register_flush_writeln()
+            {
+                hpx::register_pre_shutdown_function(&flush_writeln);
+            }
+        };
+
+        register_flush_writeln flush_writeln_at_shutdown;
+    }    // namespace detail
+
+    void flush_writeln()
+    {
+        for (auto& buffer : detail::get_writeln_buffers())
+        {
+            std::string batch;
+            {
+                std::lock_guard<hpx::spinlock> l(buffer.data_.mtx);
+                std::swap(batch, buffer.data_.data);
+            }
+
+            if (!batch.empty())
+            {
+                detail::write_console(batch);
+            }
+        }
+    }
+}    // namespace chapel
@@ -4,11 +4,12 @@
 //  Distributed under the Boost Software License, Version 1.0. (See accompanying
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#include <hpx/algorithm.hpp>
-#include <hpx/iostream.hpp>
-#include <hpx/modules/format.hpp>
 #include <hpx/modules/program_options.hpp>
 
+#include <chapel/loop_trace.hpp>
+#include <chapel/range.hpp>
+#include <chapel/writeln.hpp>
+
 #include "hello3-datapar.hpp"
 
 // Data-parallel hello world
@@ -25,7 +26,11 @@ namespace hello3_datapar {
     // messages to print out.  The default can be overridden on the
     // command-line (e.g., ``./hello --numMessages=1000000``).
     //
+#if defined(CHAPEL_PARAM_numMessages)
+    constexpr int numMessages = CHAPEL_PARAM_numMessages;
+#else
     int numMessages = 100;
+#endif
 
     hpx::program_options::options_description get_config_variables()
     {
@@ -33,9 +38,11 @@ namespace hello3_datapar {
 
         // clang-format off
         options.add_options()
+#if !defined(CHAPEL_PARAM_numMessages)
             ("numMessages",
                 hpx::program_options::value<int>(&numMessages),
                 R"(config const numMessages = 100")")
+#endif
         ;
         // clang-format on
 
@@ -60,15 +67,15 @@ namespace hello3_datapar {
     {
         void operator()(int msg) const
         {
-            hpx::util::format_to(hpx::cout,
-                "Hello, world! (from iteration {} of {})\n", msg, numMessages);
+            chapel::writeln("Hello, world! (from iteration ", msg, " of ",
+                numMessages, ")");
         }
     };
 
     void init()
     {
-        hpx::experimental::for_loop(
-            hpx::execution::par, 0, numMessages, forall_1());
+        chapel::loop_name name("forall_1");
+        chapel::forall(chapel::range(1, numMessages), forall_1());
     }
 
     //
@@ -4,13 +4,15 @@
 //  Distributed under the Boost Software License, Version 1.0. (See accompanying
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#include <hpx/iostream.hpp>
-#include <hpx/modules/algorithms.hpp>
-#include <hpx/modules/distribution_policies.hpp>
-#include <hpx/modules/executors_distributed.hpp>
-#include <hpx/modules/format.hpp>
 #include <hpx/modules/program_options.hpp>
-#include <hpx/modules/runtime_distributed.hpp>
+
+#include <chapel/distributions.hpp>
+#include <chapel/forall.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/range.hpp>
+#include <chapel/writeln.hpp>
+
+#include <cstdint>
 
 #include "hello4-datapar-dist.hpp"
 
@@ -31,7 +33,11 @@ namespace hello4_datapar_dist {
     //
     // Declare the number of messages to print:
     //
+#if defined(CHAPEL_PARAM_numMessages)
+    constexpr int numMessages = CHAPEL_PARAM_numMessages;
+#else
     int numMessages = 100;
+#endif
 
     hpx::program_options::options_description get_config_variables()
     {
@@ -39,36 +45,63 @@ namespace hello4_datapar_dist {
 
         // clang-format off
         options.add_options()
+#if !defined(CHAPEL_PARAM_numMessages)
             ("numMessages",
                 hpx::program_options::value<int>(&numMessages),
                 R"(config const numMessages = 100")")
+#endif
         ;
         // clang-format on
 
         return options;
     }
 
+    //
+    // By using the distributed domain `MessageSpace` to drive the following
+    // forall-loop, each iteration will be executed by the locale which owns
+    // that index, resulting in the distribution of the work across all the
+    // program's compute nodes. In addition, each locale will also use its
+    // available processing units (cores) to execute its local iterations in
+    // parallel.
+    //
     struct forall_1
     {
-        void operator()(int msg) const
+        void operator()(std::int64_t msg) const
+        {
+            chapel::writeln("Hello, world! (from iteration ", msg, " of ",
+                numMessages, " owned by locale ", chapel::here().id + 1, " of ",
+                chapel::numLocales(), ")");
+        }
+
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
         {
-            hpx::util::format_to(hpx::cout,
-                "Hello, world! (from iteration {} of {} owned by locale {} of "
-                "{})\n",
-                msg, numMessages, hpx::get_locality_id() + 1,
-                hpx::get_num_localities(hpx::launch::sync));
         }
     };
 
     void init()
     {
-        auto exec = hpx::parallel::execution::distribution_policy_executor(
-            hpx::components::default_layout);
+        //
+        // Here, we declare a `domain` (an index set) named `MessageSpace` that
+        // represents the indices ``1..numMessages`` and is `domain mapped`
+        // (``dmapped``) using the standard `Cyclic` distribution. This causes
+        // its indices to be distributed across the locales in a round-robin
+        // fashion where `startIdx` is mapped to locale #0.
+        //
+        chapel::Cyclic const MessageSpace(
+            chapel::range(1, numMessages), /*startIdx=*/1);
 
-        hpx::experimental::for_loop(
-            hpx::execution::par.on(exec), 1, numMessages + 1, forall_1());
+        chapel::forall(MessageSpace, forall_1());
     }
 
+    //
+    // Note that by changing the domain map of `MessageSpace` above (either by
+    // changing the arguments to `Cyclic` or switching to another domain map
+    // altogether, e.g. `Block` or `BlockCyclic`), we can alter the
+    // distribution and scheduling of the forall-loop's iterations without
+    // changing the loop itself.
+    //
+
     void main()
     {
         init();
@@ -4,10 +4,15 @@
 //  Distributed under the Boost Software License, Version 1.0. (See accompanying
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#include <hpx/iostream.hpp>
-#include <hpx/modules/algorithms.hpp>
-#include <hpx/modules/execution.hpp>
-#include <hpx/modules/format.hpp>
+#include <hpx/modules/program_options.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/loop_trace.hpp>
+#include <chapel/range.hpp>
+#include <chapel/writeln.hpp>
+
+#include <cstdint>
 
 #include "hello5-taskpar.hpp"
 
@@ -25,7 +30,15 @@ namespace hello5_taskpar {
     // default, set it to the runtime's estimation of maximum parallelism that
     // the current locale ('`here`') is capable of executing (``.maxTaskPar``).
     //
-    int numTasks = 100;
+    // The value -1 stands for `here.maxTaskPar`, which is known only once the
+    // runtime has been started (thus it can't be used if `numTasks` is made a
+    // param).
+    //
+#if defined(CHAPEL_PARAM_numTasks)
+    constexpr int numTasks = CHAPEL_PARAM_numTasks;
+#else
+    int numTasks = -1;
+#endif
 
     hpx::program_options::options_description get_config_variables()
     {
@@ -33,9 +46,11 @@ namespace hello5_taskpar {
 
         // clang-format off
         options.add_options()
+#if !defined(CHAPEL_PARAM_numTasks)
             ("numTasks",
                 hpx::program_options::value<int>(&numTasks),
-                R"(config const numTasks = 100")")
+                R"(config const numTasks = here.maxTaskPar")")
+#endif
         ;
         // clang-format on
 
@@ -58,19 +73,24 @@ namespace hello5_taskpar {
     //
     struct coforall_1
     {
-        void operator()(int tid) const
+        void operator()(std::int64_t tid) const
         {
-            hpx::util::format_to(hpx::cout,
-                "Hello, world! (from task {} of {})\n", tid + 1, numTasks);
+            chapel::writeln(
+                "Hello, world! (from task ", tid + 1, " of ", numTasks, ")");
         }
     };
 
     void init()
     {
-        auto chunk_size = hpx::execution::experimental::static_chunk_size(1);
+#if !defined(CHAPEL_PARAM_numTasks)
+        if (numTasks == -1)
+        {
+            numTasks = static_cast<int>(chapel::here().maxTaskPar);
+        }
+#endif
 
-        hpx::experimental::for_loop(
-            hpx::execution::par.with(chunk_size), 0, numTasks, coforall_1());
+        chapel::loop_name name("coforall_1");
+        chapel::coforall(chapel::counted(0, numTasks), coforall_1());
     }
 
     void main()
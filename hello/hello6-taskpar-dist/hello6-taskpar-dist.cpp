@@ -4,13 +4,17 @@
 //  Distributed under the Boost Software License, Version 1.0. (See accompanying
 //  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
-#include <hpx/iostream.hpp>
-#include <hpx/modules/algorithms.hpp>
-#include <hpx/modules/distribution_policies.hpp>
-#include <hpx/modules/executors_distributed.hpp>
-#include <hpx/modules/format.hpp>
 #include <hpx/modules/program_options.hpp>
-#include <hpx/modules/runtime_distributed.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/coforall_locales.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/loop_trace.hpp>
+#include <chapel/range.hpp>
+#include <chapel/string.hpp>
+#include <chapel/writeln.hpp>
+
+#include <cstdint>
 
 #include "hello6-taskpar-dist.hpp"
 
@@ -33,12 +37,20 @@ namespace hello6_taskpar_dist {
     // overridden on the execution command line (e.g.,
     // ``--printLocaleName=false``).
     //
+#if defined(CHAPEL_PARAM_printLocaleName)
+    constexpr bool printLocaleName = CHAPEL_PARAM_printLocaleName;
+#else
     bool printLocaleName = true;
+#endif
 
     //
     // This one specifies the number of tasks to use per locale:
     //
+#if defined(CHAPEL_PARAM_tasksPerLocale)
+    constexpr int tasksPerLocale = CHAPEL_PARAM_tasksPerLocale;
+#else
     int tasksPerLocale = 1;
+#endif
 
     hpx::program_options::options_description get_config_variables()
     {
@@ -46,12 +58,16 @@ namespace hello6_taskpar_dist {
 
         // clang-format off
         options.add_options()
+#if !defined(CHAPEL_PARAM_printLocaleName)
             ("printLocaleName",
                 hpx::program_options::value<bool>(&printLocaleName),
                 R"(config const printLocaleName = true")")
+#endif
+#if !defined(CHAPEL_PARAM_tasksPerLocale)
             ("tasksPerLocale",
                 hpx::program_options::value<int>(&tasksPerLocale),
                 R"(config const tasksPerLocale = 1")")
+#endif
         ;
         // clang-format on
 
@@ -68,13 +84,15 @@ namespace hello6_taskpar_dist {
     //
     struct coforall_2
     {
-        void operator()(int tid) const
+        void operator()(std::int64_t tid) const
         {
             //
             // Start building up the message to print using a string variable,
-            // `message`.
+            // `message`. Its memory is taken from the arena of this task and
+            // released as a whole when the task ends.
             //
-            std::string message = "Hello, world! (from ";
+            chapel::task_arena arena;
+            chapel::string message("Hello, world! (from ", arena);
 
             //
             // If we're running more than one task per locale, specialize the
@@ -82,8 +100,8 @@ namespace hello6_taskpar_dist {
             //
             if (tasksPerLocale > 1)
             {
-                message += "task " + std::to_string(tid + 1) + " of " +
-                    std::to_string(tasksPerLocale) + " on ";
+                message.append(
+                    "task ", tid + 1, " of ", tasksPerLocale, " on ");
             }
 
             //
@@ -97,13 +115,12 @@ namespace hello6_taskpar_dist {
             // - `numLocales` refers to the number of locales (as specified by
             //   -nl)
             //
-            message += "locale " + std::to_string(hpx::get_locality_id() + 1) +
-                " of " +
-                std::to_string(hpx::get_num_localities(hpx::launch::sync));
+            message.append(
+                "locale ", chapel::here().id + 1, " of ", chapel::numLocales());
 
             if (printLocaleName)
             {
-                message += " named " + hpx::get_locality_name();
+                message.append(" named ", chapel::here().name);
             }
 
             //
@@ -115,13 +132,13 @@ namespace hello6_taskpar_dist {
             // Print out the message.  Since each message is being printed by a
             // distinct task, they may appear in an arbitrary order.
             //
-            hpx::util::format_to(hpx::cout, "{}\n", message);
+            chapel::writeln(message);
         }
     };
 
     struct coforall_1
     {
-        void operator()(int) const
+        void operator()(chapel::locale const&) const
         {
             //
             // Now use a second coforall-loop to create a number of tasks
@@ -129,11 +146,14 @@ namespace hello6_taskpar_dist {
             // Since this loop body doesn't contain any on-clauses, all tasks
             // will remain local to the current locale.
             //
-            auto chunk_size =
-                hpx::execution::experimental::static_chunk_size(1);
+            chapel::loop_name name("coforall_2");
+            chapel::coforall(
+                chapel::counted(0, tasksPerLocale), coforall_2());
+        }
 
-            hpx::experimental::for_loop(hpx::execution::par.with(chunk_size), 0,
-                tasksPerLocale, coforall_2());
+        template <typename Archive>
+        void serialize(Archive&, unsigned)
+        {
         }
     };
 
@@ -144,13 +164,7 @@ namespace hello6_taskpar_dist {
         // using an `'on'-clause`, which moves execution of the current task to
         // the locale corresponding to the expression following it.
         //
-        auto exec = hpx::parallel::execution::distribution_policy_executor(
-            hpx::components::default_layout);
-        auto chunk_size = hpx::execution::experimental::static_chunk_size(1);
-
-        hpx::experimental::for_loop(
-            hpx::execution::par.on(exec).with(chunk_size), 0,
-            hpx::get_num_localities(hpx::launch::sync), coforall_1());
+        chapel::coforall_locales(coforall_1());
     }
 
     void main()
@@ -6,6 +6,8 @@
 
 #include <hpx/hpx_init.hpp>
 
+#include <chapel/config.hpp>
+
 #include "hello6-taskpar-dist.hpp"
 
 int hpx_main(int argc, char* argv[])
@@ -18,6 +20,7 @@ int main(int argc, char* argv[])
 {
     hpx::program_options::options_description desc_commandline;
     desc_commandline.add(hello6_taskpar_dist::get_config_variables());
+    desc_commandline.add(chapel::get_config_variables());
 
     hpx::init_params init_args;
     init_args.desc_cmdline = desc_commandline;
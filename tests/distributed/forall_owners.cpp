@@ -0,0 +1,124 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A distributed forall-loop executes every index on its owner, and sends
+// messages only to the locales owning at least one index.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/comm_diagnostics.hpp>
+#include <chapel/config.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/forall.hpp>
+#include <chapel/locales.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+// the number of iterations executed by this locale
+std::atomic<std::int64_t> visited(0);
+
+std::int64_t take_visited()
+{
+    return visited.exchange(0);
+}
+
+struct take_visited_action
+  : hpx::actions::make_action<decltype(&take_visited), &take_visited,
+        take_visited_action>::type
+{
+};
+
+template <typename Dist>
+struct record_index
+{
+    void operator()(std::int64_t i) const
+    {
+        if (dist.owner(i) != chapel::here().id)
+        {
+            HPX_THROW_EXCEPTION(hpx::error::assertion_failure,
+                "record_index", "index {} executed on locale {}", i,
+                chapel::here().id);
+        }
+        ++visited;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, unsigned)
+    {
+        // clang-format off
+        ar & dist;
+        // clang-format on
+    }
+
+    Dist dist;
+};
+
+template <typename Dist>
+void check_forall(Dist const& dist)
+{
+    chapel::resetCommDiagnostics();
+    chapel::startCommDiagnostics();
+
+    chapel::forall(dist, record_index<Dist>{dist});
+
+    chapel::stopCommDiagnostics();
+
+    std::uint64_t spawned = 0;
+    for (chapel::commDiagnostics const& d : chapel::getCommDiagnostics())
+    {
+        spawned += d.execute_on_nb;
+    }
+
+    std::uint64_t owners = 0;
+    for (std::uint32_t loc = 0; loc != chapel::numLocales(); ++loc)
+    {
+        std::int64_t const expected =
+            loc < dist.num_locales() ? dist.local(loc).size() : 0;
+        if (expected != 0)
+        {
+            ++owners;
+        }
+
+        std::int64_t const count =
+            hpx::async<take_visited_action>(
+                hpx::naming::get_id_from_locality_id(loc))
+                .get();
+        HPX_TEST_EQ(count, expected);
+    }
+
+    // one message per owning locale, except for the calling one
+    bool const caller_owns = !dist.local(chapel::here().id).empty();
+    HPX_TEST_EQ(spawned, owners - (caller_owns ? 1 : 0));
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    check_forall(chapel::Block(0, 1000));
+    check_forall(chapel::Block(0, 2));    // most locales own no index
+    check_forall(chapel::Block(0, 0));
+    check_forall(chapel::Cyclic(0, 3, 1));
+    check_forall(chapel::BlockCyclic(0, 5, 0, 4));
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
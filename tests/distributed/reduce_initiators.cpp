@@ -0,0 +1,120 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Distributed reductions and scans initiated by different locales share the
+// collective operations of all locales, which must not confuse operations
+// initiated by one locale with operations initiated by another one.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/actions_base.hpp>
+#include <hpx/modules/async_distributed.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/runtime_distributed.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/dist_reduce.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstdint>
+
+constexpr std::int64_t num_indices = 1000;
+
+struct index_value
+{
+    std::int64_t operator()(std::int64_t i) const
+    {
+        return i;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+// Verify the scan of the indices [0, num_indices)
+struct check_scan
+{
+    void operator()(std::int64_t i, std::int64_t s) const
+    {
+        std::int64_t const expected =
+            inclusive ? i * (i + 1) / 2 : i * (i - 1) / 2;
+        if (s != expected)
+        {
+            HPX_THROW_EXCEPTION(hpx::error::assertion_failure, "check_scan",
+                "unexpected result of scan at index {}: {} (expected {})", i,
+                s, expected);
+        }
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, unsigned)
+    {
+        // clang-format off
+        ar & inclusive;
+        // clang-format on
+    }
+
+    bool inclusive = true;
+};
+
+// Executed on the locale initiating the operations
+std::int64_t initiate_reduce_and_scan()
+{
+    chapel::Block const dist(0, num_indices);
+
+    chapel::inclusive_scan(
+        dist, chapel::sum_op<std::int64_t>(), index_value(), check_scan{true});
+    chapel::exclusive_scan(
+        dist, chapel::sum_op<std::int64_t>(), index_value(), check_scan{false});
+
+    return chapel::reduce(dist, chapel::sum_op<std::int64_t>(), index_value());
+}
+
+struct initiate_reduce_and_scan_action
+  : hpx::actions::make_action<decltype(&initiate_reduce_and_scan),
+        &initiate_reduce_and_scan, initiate_reduce_and_scan_action>::type
+{
+};
+
+int hpx_main(int argc, char* argv[])
+{
+    std::int64_t const expected = num_indices * (num_indices - 1) / 2;
+
+    // Locale #0 runs a few operations before every other locale initiates
+    // its own, and so on in turn
+    for (int round = 0; round != 3; ++round)
+    {
+        for (std::uint32_t loc = 0; loc != chapel::numLocales(); ++loc)
+        {
+            for (int i = 0; i <= round; ++i)
+            {
+                std::int64_t const result =
+                    hpx::async<initiate_reduce_and_scan_action>(
+                        hpx::naming::get_id_from_locality_id(loc))
+                        .get();
+                HPX_TEST_EQ(result, expected);
+            }
+        }
+    }
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
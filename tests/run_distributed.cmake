@@ -0,0 +1,163 @@
+# Copyright (c) 2023 Hartmut Kaiser
+#
+# SPDX-License-Identifier: BSL-1.0
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+# Run EXECUTABLE on LOCALITIES localities (using hpxrun.py) and verify its
+# output: EXPECTED_LINES (if given) lines have to match EXPECTED_REGEX.
+#
+# The console output is stored in ${OUTPUT}.log, the parcel counters of all
+# localities in ${OUTPUT}.counters, and a summary (runtime, parcel counts,
+# the remote operations counted by the Chapel runtime, and the latency of the
+# distributed phases reported by the overheads benchmark) in
+# ${OUTPUT}.summary.
+#
+# If MAX_SECONDS is given, the test fails if the distributed phase took
+# longer: every distributed loop of the overheads benchmark, or the whole
+# run of any other executable (as reported by the uptime counter of
+# locality 0, or measured by this script if the counter is not available).
+
+set(counters
+    "/parcels{locality#*/total}/count/sent"
+    "/parcels{locality#*/total}/count/received"
+    "/messages{locality#*/total}/count/sent"
+    "/data{locality#*/total}/count/sent"
+    "/runtime{locality#0/total}/uptime"
+    "/chapel{locality#*/total}/comm/get"
+    "/chapel{locality#*/total}/comm/put"
+    "/chapel{locality#*/total}/comm/execute_on"
+    "/chapel{locality#*/total}/comm/execute_on_nb"
+)
+
+set(counter_args --hpx:print-counter-destination=${OUTPUT}.counters)
+foreach(counter ${counters})
+  list(APPEND counter_args --hpx:print-counter=${counter})
+endforeach()
+
+separate_arguments(args UNIX_COMMAND "${ARGS}")
+
+file(REMOVE ${OUTPUT}.counters)
+
+string(TIMESTAMP start "%s" UTC)
+execute_process(
+  COMMAND
+    ${PYTHON} ${HPXRUN} ${EXECUTABLE} -e 0 -l ${LOCALITIES} -t ${THREADS} -p
+    ${PARCELPORT} -r ${RUNWRAPPER} -- ${args} ${counter_args}
+  OUTPUT_VARIABLE output
+  ERROR_VARIABLE errors
+  RESULT_VARIABLE result
+)
+
+string(TIMESTAMP stop "%s" UTC)
+math(EXPR elapsed "${stop} - ${start}")
+
+file(WRITE ${OUTPUT}.log "${output}")
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${EXECUTABLE} failed (${result}):\n${output}${errors}")
+endif()
+
+if(EXPECTED_LINES)
+  string(REGEX MATCHALL "${EXPECTED_REGEX}" matches "${output}")
+  list(LENGTH matches lines)
+  if(NOT lines EQUAL EXPECTED_LINES)
+    message(
+      FATAL_ERROR
+        "expected ${EXPECTED_LINES} lines matching '${EXPECTED_REGEX}', "
+        "found ${lines}:\n${output}"
+    )
+  endif()
+endif()
+
+# Summarize the counters, every line is <name>,<count>,<time>,<value>
+set(summary "localities: ${LOCALITIES}\nparcelport: ${PARCELPORT}\n")
+string(APPEND summary "elapsed: ${elapsed}[s]\n")
+
+# the duration of the distributed phase(s) in seconds
+set(durations)
+set(uptime)
+
+if(EXISTS ${OUTPUT}.counters)
+  file(STRINGS ${OUTPUT}.counters lines)
+  foreach(
+    counter
+    parcels/count/sent
+    parcels/count/received
+    messages/count/sent
+    data/count/sent
+    chapel/comm/get
+    chapel/comm/put
+    chapel/comm/execute_on
+    chapel/comm/execute_on_nb
+  )
+    string(REPLACE "/" ";" parts ${counter})
+    list(POP_FRONT parts object)
+    list(JOIN parts "/" name)
+
+    set(total 0)
+    foreach(line ${lines})
+      if(line MATCHES "^/${object}{[^}]*}/${name},[^,]*,[^,]*,([0-9]+)")
+        math(EXPR total "${total} + ${CMAKE_MATCH_1}")
+      endif()
+    endforeach()
+    string(APPEND summary "${counter}: ${total}\n")
+  endforeach()
+
+  foreach(line ${lines})
+    if(line MATCHES "^/runtime{[^}]*}/uptime,[^,]*,[^,]*,(.*)$")
+      string(APPEND summary "runtime/uptime: ${CMAKE_MATCH_1}\n")
+      if(CMAKE_MATCH_1 MATCHES "^([0-9.]+)")
+        set(uptime ${CMAKE_MATCH_1})
+      endif()
+    endif()
+  endforeach()
+endif()
+
+# The overheads benchmark reports the time of the distributed phases
+string(JSON results ERROR_VARIABLE json_error GET "${output}" results)
+if(NOT json_error)
+  string(JSON count LENGTH "${results}")
+  if(count GREATER 0)
+    math(EXPR last "${count} - 1")
+    foreach(i RANGE ${last})
+      string(JSON benchmark GET "${results}" ${i} benchmark)
+      if(benchmark MATCHES "_dist$")
+        string(JSON entry GET "${results}" ${i})
+        string(APPEND summary "${benchmark}: ${entry}\n")
+        string(JSON time GET "${entry}" time_s)
+        list(APPEND durations "${benchmark}=${time}")
+      endif()
+    endforeach()
+  endif()
+endif()
+
+file(WRITE ${OUTPUT}.summary "${summary}")
+message(STATUS "${summary}")
+
+if(MAX_SECONDS)
+  if(NOT durations)
+    if(uptime)
+      set(durations "runtime/uptime=${uptime}")
+    else()
+      set(durations "elapsed=${elapsed}")
+    endif()
+  endif()
+
+  set(too_slow)
+  foreach(duration ${durations})
+    string(REPLACE "=" ";" parts ${duration})
+    list(GET parts 1 seconds)
+    if(seconds GREATER MAX_SECONDS)
+      string(APPEND too_slow "  ${duration}s\n")
+    endif()
+  endforeach()
+
+  if(too_slow)
+    message(
+      FATAL_ERROR
+        "the distributed phase took longer than ${MAX_SECONDS}s:\n"
+        "${too_slow}"
+    )
+  endif()
+endif()
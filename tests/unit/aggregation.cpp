@@ -0,0 +1,101 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Aggregated writes and reads of the elements of a distributed array are
+// performed once the aggregators are flushed or destroyed, concurrent
+// updates of the same elements by different aggregators are not lost.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/aggregation.hpp>
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/dist_array.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstdint>
+#include <vector>
+
+constexpr std::int64_t num_indices = 1000;
+constexpr std::int64_t num_tasks = 4;
+
+using array_type = chapel::DistArray<std::int64_t, chapel::Cyclic>;
+
+void test_dst_aggregator(array_type& A)
+{
+    {
+        chapel::DstAggregator<std::int64_t, chapel::Cyclic> agg(A, 7);
+        for (std::int64_t i = 0; i != num_indices; ++i)
+        {
+            agg.copy(i, 2 * i);
+        }
+        agg.flush();
+    }
+
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        HPX_TEST_EQ(A.get(i), 2 * i);
+    }
+
+    // every task adds one to every element through an aggregator of its
+    // own, the remaining updates are sent by the destructor
+    chapel::coforall(0, num_tasks, [&](std::int64_t) {
+        chapel::DstAggregator<std::int64_t, chapel::Cyclic,
+            chapel::sum_op<std::int64_t>>
+            agg(A, 5);
+        for (std::int64_t i = 0; i != num_indices; ++i)
+        {
+            agg.copy(i, 1);
+        }
+    });
+
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        HPX_TEST_EQ(A.get(i), 2 * i + num_tasks);
+    }
+}
+
+void test_src_aggregator(array_type const& A)
+{
+    std::vector<std::int64_t> values(num_indices, -1);
+    {
+        chapel::SrcAggregator<std::int64_t, chapel::Cyclic> agg(A, 3);
+        for (std::int64_t i = num_indices - 1; i >= 0; --i)
+        {
+            agg.copy(values[i], i);
+        }
+        agg.flush();
+    }
+
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        HPX_TEST_EQ(values[i], A.get(i));
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    array_type A(chapel::Cyclic(0, num_indices, 0), 0);
+
+    test_dst_aggregator(A);
+    test_src_aggregator(A);
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,195 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A sync block returns only after every task begun inside of it (directly,
+// by other tasks, or inside of loops) has finished, and a cobegin waits for
+// all of its functions. Exceptions thrown by the tasks are collected.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/testing.hpp>
+#include <hpx/modules/threading.hpp>
+
+#include <chapel/begin.hpp>
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/forall.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Give the waiting task the chance to (wrongly) return first
+void delay()
+{
+    hpx::this_thread::sleep_for(std::chrono::milliseconds(10));
+}
+
+void test_sync_block()
+{
+    std::atomic<int> finished(0);
+
+    chapel::sync_block([&] {
+        for (int i = 0; i != 10; ++i)
+        {
+            chapel::begin([&] {
+                delay();
+                ++finished;
+            });
+        }
+    });
+    HPX_TEST_EQ(finished.load(), 10);
+
+    // tasks begun by other tasks are waited for as well
+    finished = 0;
+    chapel::sync_block([&] {
+        chapel::begin([&] {
+            chapel::begin([&] {
+                chapel::begin([&] {
+                    delay();
+                    ++finished;
+                });
+                delay();
+                ++finished;
+            });
+            ++finished;
+        });
+    });
+    HPX_TEST_EQ(finished.load(), 3);
+
+    // ... and so are the tasks begun inside of loops
+    finished = 0;
+    chapel::sync_block([&] {
+        chapel::coforall(0, 4, [&](std::int64_t) {
+            chapel::begin([&] {
+                delay();
+                ++finished;
+            });
+        });
+        chapel::forall(std::int64_t(0), std::int64_t(4), [&](std::int64_t) {
+            chapel::begin([&] {
+                delay();
+                ++finished;
+            });
+        });
+    });
+    HPX_TEST_EQ(finished.load(), 8);
+}
+
+void test_nested_sync_block()
+{
+    std::atomic<int> inner(0);
+    std::atomic<int> outer(0);
+
+    chapel::sync_block([&] {
+        chapel::begin([&] {
+            delay();
+            ++outer;
+        });
+
+        chapel::sync_block([&] {
+            chapel::begin([&] {
+                delay();
+                ++inner;
+            });
+        });
+        HPX_TEST_EQ(inner.load(), 1);
+
+        // tasks begun after the inner block belong to the outer one again
+        chapel::begin([&] {
+            delay();
+            ++outer;
+        });
+    });
+    HPX_TEST_EQ(outer.load(), 2);
+}
+
+void test_cobegin()
+{
+    std::atomic<int> finished(0);
+    auto task = [&] {
+        delay();
+        ++finished;
+    };
+
+    chapel::cobegin(task, task, task);
+    HPX_TEST_EQ(finished.load(), 3);
+}
+
+void test_exceptions()
+{
+    std::atomic<int> finished(0);
+
+    bool caught = false;
+    try
+    {
+        chapel::sync_block([&] {
+            for (int i = 0; i != 6; ++i)
+            {
+                chapel::begin([&, i] {
+                    if (i % 2 == 0)
+                    {
+                        throw std::runtime_error("task failed");
+                    }
+                    delay();
+                    ++finished;
+                });
+            }
+        });
+    }
+    catch (hpx::exception_list const& errors)
+    {
+        caught = true;
+        HPX_TEST_EQ(errors.size(), std::size_t(3));
+    }
+
+    // the remaining tasks have finished before the exceptions are rethrown
+    HPX_TEST(caught);
+    HPX_TEST_EQ(finished.load(), 3);
+
+    finished = 0;
+    caught = false;
+    try
+    {
+        chapel::cobegin([] { throw std::runtime_error("task failed"); },
+            [&] {
+                delay();
+                ++finished;
+            });
+    }
+    catch (hpx::exception_list const& errors)
+    {
+        caught = true;
+        HPX_TEST_EQ(errors.size(), std::size_t(1));
+    }
+
+    HPX_TEST(caught);
+    HPX_TEST_EQ(finished.load(), 1);
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_sync_block();
+    test_nested_sync_block();
+    test_cobegin();
+    test_exceptions();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
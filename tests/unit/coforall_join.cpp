@@ -0,0 +1,93 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A coforall-loop runs every iteration as a task and returns once all of
+// them have finished, the exceptions thrown by the tasks are collected.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+void test_join()
+{
+    constexpr std::int64_t count = 100;
+
+    std::vector<std::atomic<int>> visited(count);
+    chapel::coforall(0, count, [&](std::int64_t i) { ++visited[i]; });
+
+    // all tasks have finished once the loop returns
+    for (auto const& v : visited)
+    {
+        HPX_TEST_EQ(v.load(), 1);
+    }
+
+    // nested loops are joined by their enclosing loop
+    std::atomic<int> inner(0);
+    chapel::coforall(0, 4, [&](std::int64_t) {
+        chapel::coforall(
+            hpx::threads::thread_stacksize::small_, 0, 8,
+            [&](std::int64_t) { ++inner; });
+    });
+    HPX_TEST_EQ(inner.load(), 32);
+
+    // an empty loop creates no tasks
+    chapel::coforall(5, 5, [](std::int64_t) { HPX_TEST(false); });
+    chapel::coforall(5, 0, [](std::int64_t) { HPX_TEST(false); });
+}
+
+void test_exceptions()
+{
+    std::atomic<int> finished(0);
+
+    bool caught = false;
+    try
+    {
+        chapel::coforall(0, 10, [&](std::int64_t i) {
+            if (i == 3 || i == 7)
+            {
+                throw std::runtime_error("task failed");
+            }
+            ++finished;
+        });
+    }
+    catch (hpx::exception_list const& errors)
+    {
+        caught = true;
+        HPX_TEST_EQ(errors.size(), std::size_t(2));
+    }
+
+    // the remaining tasks have finished before the exceptions are rethrown
+    HPX_TEST(caught);
+    HPX_TEST_EQ(finished.load(), 8);
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_join();
+    test_exceptions();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
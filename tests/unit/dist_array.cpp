@@ -0,0 +1,111 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The elements of a distributed array can be read and written by index,
+// through the local slice, and by a forall-loop over the array.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/dist_array.hpp>
+#include <chapel/distributions.hpp>
+
+#include <cstdint>
+#include <utility>
+
+struct add_index
+{
+    void operator()(std::int64_t i, std::int64_t& a) const
+    {
+        a += i;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+template <typename Dist>
+void test_get_set(Dist const& dist)
+{
+    chapel::DistArray<std::int64_t, Dist> A(dist, 7);
+    HPX_TEST_EQ(A.size(), dist.size());
+
+    for (std::int64_t i = dist.first(); i != dist.last(); ++i)
+    {
+        HPX_TEST_EQ(A.get(i), std::int64_t(7));
+        A.set(i, i * i);
+    }
+    for (std::int64_t i = dist.first(); i != dist.last(); ++i)
+    {
+        HPX_TEST_EQ(A.get(i), i * i);
+    }
+
+    // the local slice refers to the same elements
+    chapel::local_view<std::int64_t> const local = A.local_slice();
+    HPX_TEST_EQ(local.size(), dist.local(chapel::here().id).size());
+    for (std::int64_t k = 0; k != local.size(); ++k)
+    {
+        std::int64_t const i = local.index(k);
+        HPX_TEST_EQ(local[k], i * i);
+        local[k] = -i;
+    }
+    for (std::int64_t const i : {dist.first(), dist.last() - 1})
+    {
+        HPX_TEST_EQ(A.get(i), -i);
+    }
+
+    chapel::forall(A, add_index());
+    for (std::int64_t i = dist.first(); i != dist.last(); ++i)
+    {
+        HPX_TEST_EQ(A.get(i), std::int64_t(0));
+    }
+
+    // moving transfers the elements
+    chapel::DistArray<std::int64_t, Dist> B(std::move(A));
+    HPX_TEST_EQ(A.id(), std::uint64_t(0));
+    HPX_TEST_EQ(B.get(dist.first()), std::int64_t(0));
+}
+
+void test_bool()
+{
+    chapel::DistArray<bool, chapel::Cyclic> A(chapel::Cyclic(0, 10, 0));
+    A.set(3, true);
+    HPX_TEST(A.get(3));
+    HPX_TEST(!A.get(4));
+
+    // the elements are addressable (unlike those of a std::vector<bool>)
+    if (A.dist().owner(3) == chapel::here().id)
+    {
+        chapel::local_view<bool> const local = A.local_slice();
+        bool* const element = local.begin() + local.indices().offset(3);
+        HPX_TEST(*element);
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_get_set(chapel::Block(0, 100));
+    test_get_set(chapel::Cyclic(-5, 20, 0));
+    test_get_set(chapel::BlockCyclic(3, 50, 0, 4));
+    test_bool();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
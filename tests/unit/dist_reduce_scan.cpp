@@ -0,0 +1,102 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Distributed reductions and scans compute the same results as their serial
+// equivalents.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/dist_reduce.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstdint>
+#include <vector>
+
+constexpr std::int64_t num_indices = 1000;
+
+struct index_value
+{
+    std::int64_t operator()(std::int64_t i) const
+    {
+        return i;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+// the results of the scans, indexed by the index
+std::vector<std::int64_t> scan_results;
+
+struct store_scan
+{
+    void operator()(std::int64_t i, std::int64_t s) const
+    {
+        scan_results[i] = s;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+template <typename Dist>
+void test_dist_reduce(Dist const& dist)
+{
+    std::int64_t const sum =
+        chapel::reduce(dist, chapel::sum_op<std::int64_t>(), index_value());
+    HPX_TEST_EQ(sum, num_indices * (num_indices - 1) / 2);
+}
+
+void test_dist_scan()
+{
+    chapel::Block const dist(0, num_indices);
+
+    scan_results.assign(num_indices, -1);
+    chapel::inclusive_scan(
+        dist, chapel::sum_op<std::int64_t>(), index_value(), store_scan());
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        HPX_TEST_EQ(scan_results[i], i * (i + 1) / 2);
+    }
+
+    scan_results.assign(num_indices, -1);
+    chapel::exclusive_scan(
+        dist, chapel::sum_op<std::int64_t>(), index_value(), store_scan());
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        HPX_TEST_EQ(scan_results[i], i * (i - 1) / 2);
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_dist_reduce(chapel::Block(0, num_indices));
+    test_dist_reduce(chapel::Cyclic(0, num_indices, 0));
+    test_dist_reduce(chapel::BlockCyclic(0, num_indices, 0, 16));
+
+    test_dist_scan();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,94 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Every index of a distribution is owned by exactly one locale, and local()
+// returns the indices owned by a locale in increasing order.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/distributions.hpp>
+
+#include <cstdint>
+#include <vector>
+
+template <typename Dist>
+void check_local(Dist const& dist)
+{
+    std::vector<int> owners(static_cast<std::size_t>(dist.size()), 0);
+    for (std::uint32_t loc = 0; loc != dist.num_locales(); ++loc)
+    {
+        chapel::local_indices const local = dist.local(loc);
+
+        std::int64_t previous = dist.first() - 1;
+        for (std::int64_t k = 0; k != local.size(); ++k)
+        {
+            std::int64_t const idx = local[k];
+            HPX_TEST_LT(previous, idx);
+            HPX_TEST_LT(idx, dist.last());
+            HPX_TEST_EQ(dist.owner(idx), loc);
+            HPX_TEST_EQ(local.offset(idx), k);
+
+            if (idx >= dist.first() && idx < dist.last())
+            {
+                ++owners[idx - dist.first()];
+            }
+            previous = idx;
+        }
+    }
+
+    for (int count : owners)
+    {
+        HPX_TEST_EQ(count, 1);
+    }
+}
+
+std::vector<std::int64_t> indices(chapel::local_indices const& local)
+{
+    std::vector<std::int64_t> result;
+    local.for_each([&](std::int64_t idx) { result.push_back(idx); });
+    return result;
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    check_local(chapel::Block(0, 100, 4));
+    check_local(chapel::Block(-7, 10, 3));
+    check_local(chapel::Block(0, 2, 4));    // more locales than indices
+    check_local(chapel::Block(5, 5, 3));
+
+    check_local(chapel::Cyclic(0, 100, 0, 4));
+    check_local(chapel::Cyclic(-5, 17, 3, 3));
+    check_local(chapel::Cyclic(10, 20, -2, 4));
+
+    check_local(chapel::BlockCyclic(0, 100, 0, 8, 4));
+    check_local(chapel::BlockCyclic(-13, 50, 5, 4, 3));
+    check_local(chapel::BlockCyclic(3, 7, 0, 10, 2));
+
+    HPX_TEST(indices(chapel::Block(0, 10, 3).local(1)) ==
+        std::vector<std::int64_t>({3, 4, 5}));
+    HPX_TEST(indices(chapel::Cyclic(0, 10, 0, 3).local(1)) ==
+        std::vector<std::int64_t>({1, 4, 7}));
+    HPX_TEST(indices(chapel::Cyclic(0, 10, 2, 3).local(0)) ==
+        std::vector<std::int64_t>({2, 5, 8}));
+    HPX_TEST(indices(chapel::BlockCyclic(0, 10, 0, 2, 2).local(1)) ==
+        std::vector<std::int64_t>({2, 3, 6, 7}));
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
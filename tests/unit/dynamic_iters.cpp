@@ -0,0 +1,79 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The dynamic, guided, and adaptive iterators execute every index exactly
+// once, whatever the number of tasks and chunk size.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/dynamic_iters.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename Iter>
+void check_coverage(Iter const& iter, std::int64_t first, std::int64_t last)
+{
+    std::int64_t const count = last > first ? last - first : 0;
+    std::vector<std::atomic<int>> visited(static_cast<std::size_t>(count));
+
+    std::atomic<bool> in_bounds(true);
+    chapel::forall(iter, [&](std::int64_t i) {
+        if (i < first || i >= last)
+        {
+            in_bounds = false;
+            return;
+        }
+        ++visited[i - first];
+    });
+
+    HPX_TEST(in_bounds);
+    for (auto const& v : visited)
+    {
+        HPX_TEST_EQ(v.load(), 1);
+    }
+}
+
+void check_all(std::int64_t first, std::int64_t last)
+{
+    for (std::size_t tasks : {0, 1, 3, 8})
+    {
+        for (std::int64_t chunk : {0, 1, 7, 1000})
+        {
+            check_coverage(
+                chapel::dynamic(first, last, chunk, tasks), first, last);
+        }
+        check_coverage(chapel::guided(first, last, tasks), first, last);
+        check_coverage(chapel::adaptive(first, last, tasks), first, last);
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    check_all(0, 1000);
+    check_all(-37, 263);
+    check_all(0, 5);      // fewer indices than tasks
+    check_all(10, 10);    // empty
+    check_all(10, 5);     // empty
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,109 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Reductions and reduce intents compute the same results as their serial
+// equivalents, non-commutative operators combine the values in index order.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/reduce.hpp>
+
+#include <cstdint>
+
+constexpr std::int64_t num_indices = 1000;
+
+// The indices [lo, hi), combining two spans is valid only if the second one
+// directly follows the first one
+struct span
+{
+    std::int64_t lo = 0;
+    std::int64_t hi = 0;
+    bool ordered = true;
+};
+
+span concat(span const& lhs, span const& rhs)
+{
+    if (lhs.lo == lhs.hi)
+        return rhs;
+    if (rhs.lo == rhs.hi)
+        return lhs;
+    return span{
+        lhs.lo, rhs.hi, lhs.ordered && rhs.ordered && lhs.hi == rhs.lo};
+}
+
+void test_reduce()
+{
+    std::int64_t const sum = chapel::reduce(0, num_indices,
+        chapel::sum_op<std::int64_t>(), [](std::int64_t i) { return i; });
+    HPX_TEST_EQ(sum, num_indices * (num_indices - 1) / 2);
+
+    std::int64_t const max = chapel::reduce(0, num_indices,
+        chapel::max_op<std::int64_t>(),
+        [](std::int64_t i) { return (i * 7919) % num_indices; });
+    HPX_TEST_EQ(max, num_indices - 1);
+
+    std::int64_t const empty = chapel::reduce(5, 5,
+        chapel::sum_op<std::int64_t>(), [](std::int64_t i) { return i; });
+    HPX_TEST_EQ(empty, 0);
+
+    std::int64_t const commutative = chapel::reduce(0, num_indices,
+        chapel::make_commutative_reduce_op(std::int64_t(0),
+            [](std::int64_t lhs, std::int64_t rhs) { return lhs ^ rhs; }),
+        [](std::int64_t i) { return i; });
+    std::int64_t expected = 0;
+    for (std::int64_t i = 0; i != num_indices; ++i)
+    {
+        expected ^= i;
+    }
+    HPX_TEST_EQ(commutative, expected);
+
+    span const s = chapel::reduce(0, num_indices,
+        chapel::make_reduce_op(span(), &concat),
+        [](std::int64_t i) { return span{i, i + 1}; });
+    HPX_TEST(s.ordered);
+    HPX_TEST_EQ(s.lo, 0);
+    HPX_TEST_EQ(s.hi, num_indices);
+}
+
+void test_reduce_intent()
+{
+    // the result of a reduce intent is combined with the initial value
+    std::int64_t total = 5;
+    chapel::forall(0, num_indices,
+        chapel::with_reduce(total, chapel::sum_op<std::int64_t>()),
+        [](std::int64_t i, std::int64_t& acc) { acc += i; });
+    HPX_TEST_EQ(total, 5 + num_indices * (num_indices - 1) / 2);
+
+    span s{-1, 0};
+    chapel::forall(0, num_indices,
+        chapel::with_reduce(s, chapel::make_reduce_op(span(), &concat)),
+        [](std::int64_t i, span& acc) { acc = concat(acc, span{i, i + 1}); });
+    HPX_TEST(s.ordered);
+    HPX_TEST_EQ(s.lo, -1);
+    HPX_TEST_EQ(s.hi, num_indices);
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_reduce();
+    test_reduce_intent();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
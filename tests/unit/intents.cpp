@@ -0,0 +1,225 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Task intents: `in` values are copied once per task (or per locale) and are
+// private to it, `ref` and `const_ref` refer to the variable itself, and
+// `reduce` accumulators are combined into the variable once the loop is done.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/intents.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/range.hpp>
+#include <chapel/reduce.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+// A value counting how often it is copied
+struct counted
+{
+    counted() = default;
+
+    explicit counted(std::int64_t value)
+      : value(value)
+    {
+    }
+
+    counted(counted&&) = default;
+    counted& operator=(counted&&) = default;
+
+    counted(counted const& rhs)
+      : value(rhs.value)
+    {
+        ++copies;
+    }
+
+    counted& operator=(counted const& rhs)
+    {
+        value = rhs.value;
+        ++copies;
+        return *this;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, unsigned)
+    {
+        // clang-format off
+        ar & value;
+        // clang-format on
+    }
+
+    std::int64_t value = 0;
+
+    static std::atomic<std::size_t> copies;
+};
+
+std::atomic<std::size_t> counted::copies(0);
+
+void test_in_forall()
+{
+    std::int64_t const n = 1000;
+    counted x(42);
+
+    counted::copies = 0;
+    std::atomic<bool> private_copy(true);
+    chapel::forall(std::int64_t(0), n, chapel::with(chapel::in(x)),
+        [&](std::int64_t, counted& v) {
+            // every task starts out with the value of x, and its own copy
+            // keeps the changes of the earlier iterations of the task
+            if (v.value < 42 || &v == &x)
+            {
+                private_copy = false;
+            }
+            ++v.value;
+        });
+
+    HPX_TEST(private_copy);
+    HPX_TEST_EQ(x.value, std::int64_t(42));
+
+    // the in_intent holds one copy, every task makes one more
+    std::size_t const max_tasks = chapel::dataParTasksPerLocale != 0 ?
+        chapel::dataParTasksPerLocale :
+        chapel::here().maxTaskPar;
+    HPX_TEST_LTE(counted::copies.load(), max_tasks + 1);
+}
+
+void test_in_coforall()
+{
+    std::int64_t const n = 10;
+    auto const w = chapel::with(chapel::in(counted(7)));
+
+    counted::copies = 0;
+    std::vector<std::int64_t> seen(n);
+    chapel::coforall(std::int64_t(0), n, w, [&](std::int64_t i, counted& v) {
+        seen[i] = v.value;
+        v.value = -1;
+    });
+
+    // one copy per task, none per iteration of the body
+    HPX_TEST_EQ(counted::copies.load(), std::size_t(n));
+    for (std::int64_t value : seen)
+    {
+        HPX_TEST_EQ(value, std::int64_t(7));
+    }
+    HPX_TEST_EQ(std::get<0>(w.intents).value.value, std::int64_t(7));
+}
+
+void test_ref_intents()
+{
+    std::atomic<std::int64_t> shared(0);
+    std::int64_t const limit = 5;
+
+    std::atomic<bool> same_limit(true);
+    chapel::forall(chapel::range(1, 100),
+        chapel::with(chapel::ref(shared), chapel::const_ref(limit)),
+        [&](std::int64_t i, std::atomic<std::int64_t>& s,
+            std::int64_t const& l) {
+            if (&l != &limit)
+            {
+                same_limit = false;
+            }
+            s += i;
+        });
+
+    HPX_TEST(same_limit);
+    HPX_TEST_EQ(shared.load(), std::int64_t(5050));
+}
+
+void test_reduce_intent()
+{
+    std::int64_t sum = 10;
+    std::int64_t max = 0;
+    chapel::forall(chapel::range(1, 1000),
+        chapel::with(chapel::with_reduce(sum, chapel::sum_op<std::int64_t>()),
+            chapel::with_reduce(max, chapel::max_op<std::int64_t>())),
+        [](std::int64_t i, std::int64_t& s, std::int64_t& m) {
+            s += i;
+            m = (std::max)(m, (i * 37) % 1000);
+        });
+
+    // the initial value of the variable takes part in the reduction
+    HPX_TEST_EQ(sum, std::int64_t(10 + 500500));
+    HPX_TEST_EQ(max, std::int64_t(999));
+
+    std::int64_t count = 0;
+    chapel::coforall(std::int64_t(0), std::int64_t(16),
+        chapel::with(
+            chapel::with_reduce(count, chapel::sum_op<std::int64_t>())),
+        [](std::int64_t, std::int64_t& c) { ++c; });
+    HPX_TEST_EQ(count, std::int64_t(16));
+}
+
+struct record_in_values
+{
+    void operator()(
+        chapel::locale const& loc, counted& x, std::int64_t& y) const
+    {
+        HPX_TEST_EQ(loc.id, chapel::here().id);
+        HPX_TEST_EQ(x.value, std::int64_t(3));
+        HPX_TEST_EQ(y, std::int64_t(4));
+
+        // the values are private to the task of the locale
+        x.value = 0;
+        y = 0;
+        ++calls;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+
+    static std::atomic<std::size_t> calls;
+};
+
+std::atomic<std::size_t> record_in_values::calls(0);
+
+void test_in_locales()
+{
+    auto const w =
+        chapel::with(chapel::in(counted(3)), chapel::in(std::int64_t(4)));
+
+    counted::copies = 0;
+    chapel::coforall_locales(w, record_in_values());
+
+    HPX_TEST_EQ(record_in_values::calls.load(), std::size_t(1));
+    HPX_TEST_EQ(std::get<0>(w.intents).value.value, std::int64_t(3));
+    HPX_TEST_EQ(std::get<1>(w.intents).value, std::int64_t(4));
+
+    // one copy is held by the loop and one by the task of this (only)
+    // locale, the body receives the latter by reference
+    HPX_TEST_LTE(counted::copies.load(), std::size_t(2));
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_in_forall();
+    test_in_coforall();
+    test_ref_intents();
+    test_reduce_intent();
+    test_in_locales();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
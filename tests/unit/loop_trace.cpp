@@ -0,0 +1,115 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Traced loops are named by the innermost loop_name, which is inherited by
+// the tasks of the loops (and by tasks created by `begin`), and unplaced
+// tasks are never counted as misplaced.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/begin.hpp>
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/forall.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/loop_trace.hpp>
+#include <chapel/range.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+std::size_t count_occurrences(std::string const& s, std::string const& what)
+{
+    std::size_t count = 0;
+    for (std::size_t pos = s.find(what); pos != std::string::npos;
+        pos = s.find(what, pos + what.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+void test_loop_names()
+{
+    chapel::clear_loop_trace();
+
+    {
+        chapel::loop_name outer_name("outer");
+
+        chapel::coforall(std::int64_t(0), std::int64_t(2), [](std::int64_t) {
+            chapel::forall(chapel::range(1, 1000), [](std::int64_t) {});
+
+            chapel::loop_name inner_name("inner");
+            chapel::forall(chapel::range(1, 1000), [](std::int64_t) {});
+        });
+
+        chapel::sync_block([] {
+            chapel::begin([] {
+                chapel::forall(chapel::range(1, 1000), [](std::int64_t) {});
+            });
+        });
+    }
+
+    {
+        chapel::loop_name after_name("after");
+        chapel::forall(chapel::range(1, 1000), [](std::int64_t) {});
+    }
+
+    std::ostringstream os;
+    chapel::write_loop_trace(os);
+    std::string const trace = os.str();
+
+    // every loop record carries the number of tasks, the records of its
+    // tasks don't
+    std::string const outer_coforall =
+        "\"name\": \"outer\", \"cat\": \"coforall\"";
+    std::string const outer_forall = "\"name\": \"outer\", \"cat\": \"forall\"";
+    std::string const inner_forall = "\"name\": \"inner\", \"cat\": \"forall\"";
+    std::string const after_forall = "\"name\": \"after\", \"cat\": \"forall\"";
+
+    HPX_TEST_NEQ(count_occurrences(trace, outer_coforall), std::size_t(0));
+
+    // two forall-loops nested in the coforall, one run by a begun task
+    std::size_t const loops = count_occurrences(trace, "\"tasks\": ");
+    HPX_TEST_NEQ(count_occurrences(trace, outer_forall), std::size_t(0));
+    HPX_TEST_NEQ(count_occurrences(trace, inner_forall), std::size_t(0));
+    HPX_TEST_NEQ(count_occurrences(trace, after_forall), std::size_t(0));
+    HPX_TEST_EQ(loops, std::size_t(7));
+
+    // tasks are placed on NUMA domains only if there is more than one
+    if (chapel::here().getChildCount() <= 1)
+    {
+        HPX_TEST_EQ(count_occurrences(trace, "\"misplaced\": 0"), loops);
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+#if !defined(CHAPEL_PARAM_traceLoops)
+    chapel::traceLoops = true;
+    test_loop_names();
+
+    // don't write the trace file at shutdown
+    chapel::traceLoops = false;
+#endif
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,99 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A forall-loop nested inside a coforall-loop uses fewer tasks than one
+// started from an otherwise idle locale, as the tasks of the enclosing
+// coforall are already occupying the cores.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/runtime_local.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/detail/forall_tasks.hpp>
+#include <chapel/forall.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr std::int64_t num_indices = 10000;
+
+// Busy-wait (instead of suspending) so that all tasks of the coforall stay
+// active while any one of them looks at the number of running tasks.
+void spin_until(std::atomic<std::size_t>& counter, std::size_t count)
+{
+    ++counter;
+    while (counter.load() != count)
+    {
+    }
+}
+
+void test_nested_forall()
+{
+    std::size_t const outer = chapel::detail::forall_num_tasks(num_indices);
+
+    // one coforall task per worker thread, otherwise the spinning tasks would
+    // keep the remaining ones from ever starting
+    std::size_t const workers = hpx::get_os_thread_count();
+
+    std::atomic<std::size_t> arrived(0);
+    std::atomic<std::size_t> measured(0);
+    std::vector<std::size_t> inner(workers);
+    std::vector<std::int64_t> sums(workers);
+
+    chapel::coforall(
+        std::int64_t(0), std::int64_t(workers), [&](std::int64_t task) {
+            spin_until(arrived, workers);
+            inner[task] = chapel::detail::forall_num_tasks(num_indices);
+            spin_until(measured, workers);
+
+            // the nested loop still executes every index exactly once
+            std::atomic<std::int64_t> sum(0);
+            chapel::forall(std::int64_t(0), num_indices,
+                [&](std::int64_t i) { sum += i; });
+            sums[task] = sum.load();
+        });
+
+    for (std::size_t task = 0; task != workers; ++task)
+    {
+        HPX_TEST_LTE(inner[task], outer);
+        if (outer > 1 && workers > 1)
+        {
+            HPX_TEST_LT(inner[task], outer);
+        }
+        HPX_TEST_EQ(sums[task], num_indices * (num_indices - 1) / 2);
+    }
+}
+
+int hpx_main(int argc, char* argv[])
+{
+#if !defined(CHAPEL_PARAM_dataParIgnoreRunningTasks)
+    // running tasks are taken into account by default
+    HPX_TEST(!chapel::dataParIgnoreRunningTasks);
+#endif
+
+    if (!chapel::dataParIgnoreRunningTasks)
+    {
+        test_nested_forall();
+    }
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
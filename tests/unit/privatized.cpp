@@ -0,0 +1,155 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Privatized objects are replicated on every locale, updates are broadcast
+// to all replicas, and the IDs of released objects are reused.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/coforall_locales.hpp>
+#include <chapel/locales.hpp>
+#include <chapel/privatization.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct params
+{
+    std::int64_t scale = 0;
+    std::vector<std::int64_t> offsets;
+
+    template <typename Archive>
+    void serialize(Archive& ar, unsigned)
+    {
+        // clang-format off
+        ar & scale & offsets;
+        // clang-format on
+    }
+};
+
+std::atomic<std::int64_t> checked(0);
+
+struct check_replica
+{
+    void operator()(chapel::locale const&) const
+    {
+        params const& p = chapel::get_privatized<params>(pid);
+        HPX_TEST_EQ(p.scale, scale);
+        HPX_TEST_EQ(p.offsets.size(), std::size_t(3));
+        ++checked;
+    }
+
+    template <typename Archive>
+    void serialize(Archive& ar, unsigned)
+    {
+        // clang-format off
+        ar & pid & scale;
+        // clang-format on
+    }
+
+    std::uint64_t pid = 0;
+    std::int64_t scale = 0;
+};
+
+struct double_scale
+{
+    void operator()(params& p) const
+    {
+        p.scale *= 2;
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+void test_broadcast()
+{
+    chapel::privatized<params> p(params{5, {1, 2, 3}});
+    HPX_TEST_EQ(p.local().scale, std::int64_t(5));
+
+    checked = 0;
+    chapel::coforall_locales(check_replica{p.id(), 5});
+    HPX_TEST_EQ(checked.load(), std::int64_t(chapel::numLocales()));
+
+    p.broadcast(double_scale());
+    chapel::coforall_locales(check_replica{p.id(), 10});
+
+    p.set(params{-1, {4, 5, 6}});
+    chapel::coforall_locales(check_replica{p.id(), -1});
+    HPX_TEST_EQ(p.local().offsets[2], std::int64_t(6));
+
+    // moving transfers the replicas
+    std::uint64_t const pid = p.id();
+    chapel::privatized<params> q(std::move(p));
+    HPX_TEST_EQ(p.id(), std::uint64_t(0));
+    HPX_TEST_EQ(q.id(), pid);
+    HPX_TEST_EQ(q.local().scale, std::int64_t(-1));
+}
+
+void test_id_reuse()
+{
+    std::uint64_t first_id = 0;
+    {
+        chapel::privatized<std::int64_t> p(0);
+        first_id = p.id();
+    }
+
+    // creating and releasing many objects doesn't use up the IDs
+    for (std::int64_t i = 0; i != 100000; ++i)
+    {
+        chapel::privatized<std::int64_t> p(i);
+        HPX_TEST_EQ(p.id(), first_id);
+        HPX_TEST_EQ(p.local(), i);
+    }
+
+    // live objects have distinct IDs, released ones are handed out again
+    std::vector<chapel::privatized<std::int64_t>> live;
+    for (std::int64_t i = 0; i != 10; ++i)
+    {
+        live.emplace_back(i);
+    }
+    for (std::int64_t i = 0; i != 10; ++i)
+    {
+        HPX_TEST_EQ(live[i].local(), i);
+        for (std::int64_t j = 0; j != i; ++j)
+        {
+            HPX_TEST_NEQ(live[i].id(), live[j].id());
+        }
+    }
+
+    std::uint64_t const released = live[4].id();
+    live[4] = chapel::privatized<std::int64_t>(40);
+    chapel::privatized<std::int64_t> p(41);
+    HPX_TEST_EQ(p.id(), released);
+    HPX_TEST_EQ(p.local(), std::int64_t(41));
+    HPX_TEST_EQ(live[4].local(), std::int64_t(40));
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_broadcast();
+    test_id_reuse();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,93 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Strided (`by`) and counted (`#`) ranges visit the same indices in the
+// same order as in Chapel.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/range.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+std::vector<std::int64_t> indices(chapel::range const& r)
+{
+    std::vector<std::int64_t> result;
+    for (std::int64_t k = 0; k != r.size(); ++k)
+    {
+        result.push_back(r[k]);
+    }
+    return result;
+}
+
+using expected = std::vector<std::int64_t>;
+
+int hpx_main(int argc, char* argv[])
+{
+    chapel::range const r(1, 10);
+
+    // 1..10 by 3
+    HPX_TEST(indices(r.by(3)) == expected({1, 4, 7, 10}));
+    HPX_TEST_EQ(r.by(3).stride(), 3);
+
+    // 1..10 by -3 starts at the high bound
+    chapel::range const down = r.by(-3);
+    HPX_TEST(indices(down) == expected({10, 7, 4, 1}));
+    HPX_TEST_EQ(down.first(), 10);
+    HPX_TEST_EQ(down.last(), 1);
+    HPX_TEST_EQ(down.low(), 1);
+    HPX_TEST_EQ(down.high(), 10);
+
+    // the strides multiply
+    HPX_TEST(indices(r.by(2).by(2)) == expected({1, 5, 9}));
+    HPX_TEST(indices(r.by(2).by(-1)) == expected({9, 7, 5, 3, 1}));
+    HPX_TEST(indices(chapel::range(0, 9).by(-2)) == expected({9, 7, 5, 3, 1}));
+
+    // 1..10 # 3, (1..10 by -3) # 2, 5..#3
+    HPX_TEST(indices(r.take(3)) == expected({1, 2, 3}));
+    HPX_TEST(indices(down.take(2)) == expected({10, 7}));
+    HPX_TEST(indices(chapel::counted(5, 3)) == expected({5, 6, 7}));
+    HPX_TEST(r.take(0).empty());
+    HPX_TEST(chapel::counted(5, -1).empty());
+
+    HPX_TEST(r.by(3).contains(7));
+    HPX_TEST(!r.by(3).contains(8));
+    HPX_TEST(!r.by(3).contains(13));
+    HPX_TEST_EQ(down.indexOrder(4), 2);
+    HPX_TEST_EQ(down.indexOrder(5), -1);
+
+    HPX_TEST(chapel::range(1, 0).by(2).empty());
+    HPX_TEST(chapel::range(1, 0).by(-2).empty());
+
+    // a forall-loop over a strided range visits every index once
+    chapel::range const strided = chapel::range(0, 999).by(-7);
+
+    std::vector<std::atomic<int>> visited(1000);
+    chapel::forall(strided, [&](std::int64_t i) { ++visited[i]; });
+
+    for (std::int64_t i = 0; i != 1000; ++i)
+    {
+        HPX_TEST_EQ(visited[i].load(), strided.contains(i) ? 1 : 0);
+    }
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,148 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// chapel::string grows beyond its inline buffer (on the heap or in an
+// arena), and the blocks of released arenas are reused.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/string.hpp>
+#include <chapel/task_arena.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+
+void test_append()
+{
+    chapel::string s("task ");
+    s.append(1, " of ", 4, ": ", -17, ' ', true, '/', false);
+    HPX_TEST_EQ(s.view(), std::string_view("task 1 of 4: -17 true/false"));
+
+    chapel::string c;
+    c.append(static_cast<signed char>('a'), static_cast<unsigned char>('b'),
+        L'c', u'é', U'\U0001f600');
+    HPX_TEST_EQ(c.view(), std::string_view("abc\xc3\xa9\xf0\x9f\x98\x80"));
+}
+
+// Append the extreme values of T to a string that is full
+template <typename T>
+void check_limits()
+{
+    for (T value :
+        {(std::numeric_limits<T>::min)(), (std::numeric_limits<T>::max)()})
+    {
+        chapel::string s;
+        std::string const fill(s.capacity(), '-');
+        s.append(fill, value);
+
+        HPX_TEST_EQ(s.view(), std::string_view(fill + std::to_string(value)));
+        HPX_TEST_EQ(s.c_str()[s.size()], '\0');
+    }
+}
+
+void test_integral_limits()
+{
+    check_limits<short>();
+    check_limits<unsigned short>();
+    check_limits<int>();
+    check_limits<unsigned>();
+    check_limits<long long>();
+    check_limits<unsigned long long>();
+}
+
+void test_growth()
+{
+    chapel::string s;
+    HPX_TEST_EQ(s.capacity(), chapel::string::inline_capacity);
+
+    std::string expected;
+    for (int i = 0; i != 1000; ++i)
+    {
+        s += 'x';
+        s += i;
+        expected += 'x';
+        expected += std::to_string(i);
+
+        HPX_TEST_EQ(s.view(), std::string_view(expected));
+        HPX_TEST_EQ(s.c_str()[s.size()], '\0');
+    }
+    HPX_TEST_LTE(s.size(), s.capacity());
+
+    chapel::string copy(s);
+    HPX_TEST(copy == s);
+
+    chapel::string moved(std::move(s));
+    HPX_TEST(moved == copy);
+    HPX_TEST(s.empty());
+    HPX_TEST_EQ(s.capacity(), chapel::string::inline_capacity);
+
+    s = "short";
+    HPX_TEST_EQ(s.view(), std::string_view("short"));
+}
+
+void test_arena()
+{
+    std::string const long_text(1000, 'y');
+
+    chapel::task_arena arena;
+    {
+        chapel::string s(arena);
+        s.append("a", long_text);
+        HPX_TEST_EQ(s.size(), long_text.size() + 1);
+
+        // moving keeps the memory of the arena, copies live on the heap
+        chapel::string moved(std::move(s));
+        chapel::string copy(moved);
+        HPX_TEST(copy == moved);
+        HPX_TEST_EQ(moved.view().substr(1), std::string_view(long_text));
+    }
+
+    // once released, the blocks of an arena are reused by the next
+    // allocations on the same worker thread
+    arena.reset();
+    void* const first = arena.allocate(64);
+    arena.reset();
+    HPX_TEST_EQ(arena.allocate(64), first);
+    arena.reset();
+
+    {
+        chapel::task_arena other;
+        HPX_TEST_EQ(other.allocate(64), first);
+    }
+
+    // oversized requests are served by the global allocator
+    void* const large =
+        arena.allocate(2 * chapel::task_arena::arena_block_size);
+    HPX_TEST_NEQ(large, first);
+    HPX_TEST_EQ(arena.allocate(64), first);
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_append();
+    test_integral_limits();
+    test_growth();
+    test_arena();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
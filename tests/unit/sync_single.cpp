@@ -0,0 +1,137 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The full/empty semantics of sync and single variables.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/coforall.hpp>
+#include <chapel/config.hpp>
+#include <chapel/sync.hpp>
+
+#include <cstdint>
+
+void test_sync()
+{
+    chapel::sync<int> s;
+    HPX_TEST(!s.isFull());
+
+    s.writeEF(1);
+    HPX_TEST(s.isFull());
+    HPX_TEST_EQ(s.readFF(), 1);
+    HPX_TEST(s.isFull());
+    HPX_TEST_EQ(s.readFE(), 1);
+    HPX_TEST(!s.isFull());
+
+    s.writeXF(2);
+    HPX_TEST(s.isFull());
+    HPX_TEST_EQ(s.readXX(), 2);
+    s.writeFF(3);
+    HPX_TEST_EQ(s.readXX(), 3);
+    HPX_TEST(s.isFull());
+
+    s.reset();
+    HPX_TEST(!s.isFull());
+    HPX_TEST_EQ(s.readXX(), 0);
+    HPX_TEST(!s.isFull());
+
+    chapel::sync<int> full(4);
+    HPX_TEST(full.isFull());
+    HPX_TEST_EQ(full.readFE(), 4);
+}
+
+// A producer and a consumer hand over values through a sync variable, every
+// value is read exactly once, in order
+void test_sync_handover()
+{
+    constexpr int count = 1000;
+
+    chapel::sync<int> s;
+    int mismatches = 0;
+
+    chapel::coforall(0, 2, [&](std::int64_t task) {
+        for (int i = 0; i != count; ++i)
+        {
+            if (task == 0)
+            {
+                s.writeEF(i);
+            }
+            else if (s.readFE() != i)
+            {
+                ++mismatches;
+            }
+        }
+    });
+
+    HPX_TEST_EQ(mismatches, 0);
+    HPX_TEST(!s.isFull());
+}
+
+void test_single()
+{
+    chapel::single<int> s;
+    HPX_TEST(!s.isFull());
+
+    // readers wait until the variable has been written
+    int values[4] = {};
+    chapel::coforall(0, 5, [&](std::int64_t task) {
+        if (task == 0)
+        {
+            s.writeEF(42);
+        }
+        else
+        {
+            values[task - 1] = s.readFF();
+        }
+    });
+
+    for (int value : values)
+    {
+        HPX_TEST_EQ(value, 42);
+    }
+    HPX_TEST(s.isFull());
+    HPX_TEST_EQ(s.readXX(), 42);
+
+    // a single variable can be written only once
+    bool thrown = false;
+    try
+    {
+        s.writeEF(43);
+    }
+    catch (hpx::exception const&)
+    {
+        thrown = true;
+    }
+    HPX_TEST(thrown);
+    HPX_TEST_EQ(s.readFF(), 42);
+
+    chapel::single<int> full(5);
+    HPX_TEST(full.isFull());
+    HPX_TEST_EQ(full.readFF(), 5);
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_sync();
+    test_sync_handover();
+    test_single();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}
@@ -0,0 +1,168 @@
+//  Copyright (c) 2023 Hartmut Kaiser
+//
+//  SPDX-License-Identifier: BSL-1.0
+//  Distributed under the Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// A zippered forall-loop yields the elements at the same position of all
+// iterands exactly once, whichever iterand leads, and rejects iterands of
+// different sizes.
+
+#include <hpx/hpx_init.hpp>
+#include <hpx/modules/errors.hpp>
+#include <hpx/modules/testing.hpp>
+
+#include <chapel/config.hpp>
+#include <chapel/dist_array.hpp>
+#include <chapel/distributions.hpp>
+#include <chapel/domain.hpp>
+#include <chapel/range.hpp>
+#include <chapel/zip.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+void test_range_leader()
+{
+    std::int64_t const n = 1000;
+    std::vector<std::int64_t> a(n);
+    std::vector<std::int64_t> b(n);
+    for (std::int64_t k = 0; k != n; ++k)
+    {
+        a[k] = 3 * k;
+    }
+
+    chapel::forall(chapel::zip(chapel::range(1, n), a, b),
+        [](std::int64_t i, std::int64_t x, std::int64_t& y) { y = i + x; });
+
+    for (std::int64_t k = 0; k != n; ++k)
+    {
+        HPX_TEST_EQ(b[k], k + 1 + 3 * k);
+    }
+}
+
+// The index of D at position k in row-major order
+std::array<std::int64_t, 2> index_at(
+    chapel::domain<2> const& D, std::int64_t k)
+{
+    std::int64_t const cols = D.dim(1).size();
+    return {D.dim(0)[k / cols], D.dim(1)[k % cols]};
+}
+
+void test_domain_leader()
+{
+    // not a multiple of the tile size along either dimension
+    chapel::domain const D(chapel::range(1, 130), chapel::range(0, 210).by(3));
+    std::vector<std::atomic<int>> visited(D.size());
+    std::atomic<bool> in_order(true);
+
+    chapel::forall(chapel::zip(D, chapel::range(0, D.size() - 1), visited),
+        [&](std::array<std::int64_t, 2> const& idx, std::int64_t k,
+            std::atomic<int>& v) {
+            if (idx != index_at(D, k))
+            {
+                in_order = false;
+            }
+            ++v;
+        });
+
+    HPX_TEST(in_order);
+    for (auto const& v : visited)
+    {
+        HPX_TEST_EQ(v.load(), 1);
+    }
+}
+
+void test_domain_follower()
+{
+    chapel::domain const D(
+        chapel::range(-2, 7), chapel::range(5, 9), chapel::range(0, 2));
+    std::atomic<bool> in_order(true);
+    std::atomic<std::int64_t> count(0);
+
+    chapel::forall(chapel::zip(chapel::range(0, D.size() - 1), D),
+        [&](std::int64_t k, std::array<std::int64_t, 3> const& idx) {
+            std::array<std::int64_t, 3> const expected = {
+                D.dim(0)[k / 15], D.dim(1)[(k / 3) % 5], D.dim(2)[k % 3]};
+            if (idx != expected)
+            {
+                in_order = false;
+            }
+            ++count;
+        });
+
+    HPX_TEST(in_order);
+    HPX_TEST_EQ(count.load(), D.size());
+}
+
+void test_local_slice()
+{
+    chapel::DistArray<std::int64_t, chapel::Block> A(chapel::Block(0, 99));
+    auto const slice = A.local_slice();
+
+    chapel::forall(chapel::zip(slice, chapel::range(0, slice.size() - 1)),
+        [](std::int64_t& a, std::int64_t k) { a = 2 * k; });
+
+    for (std::int64_t k = 0; k != slice.size(); ++k)
+    {
+        HPX_TEST_EQ(slice[k], 2 * k);
+    }
+}
+
+template <typename Zip>
+void check_size_mismatch(Zip const& z)
+{
+    std::atomic<int> calls(0);
+    bool caught = false;
+    try
+    {
+        chapel::forall(z, [&](auto const&...) { ++calls; });
+    }
+    catch (hpx::exception const& e)
+    {
+        caught = true;
+        HPX_TEST(e.get_error() == hpx::error::bad_parameter);
+    }
+
+    // the sizes are checked before any iteration is executed
+    HPX_TEST(caught);
+    HPX_TEST_EQ(calls.load(), 0);
+}
+
+void test_size_mismatch()
+{
+    std::vector<int> const v(9);
+    chapel::domain const D(chapel::range(0, 2), chapel::range(0, 2));
+
+    check_size_mismatch(chapel::zip(chapel::range(0, 9), v));
+    check_size_mismatch(chapel::zip(v, chapel::range(0, 9)));
+    check_size_mismatch(chapel::zip(D, v, chapel::range(1, 10)));
+    check_size_mismatch(chapel::zip(chapel::range(0, 9), D));
+    check_size_mismatch(chapel::zip(chapel::range(1, 0), v));
+}
+
+int hpx_main(int argc, char* argv[])
+{
+    test_range_leader();
+    test_domain_leader();
+    test_domain_follower();
+    test_local_slice();
+    test_size_mismatch();
+
+    return hpx::finalize();
+}
+
+int main(int argc, char* argv[])
+{
+    hpx::program_options::options_description desc_commandline;
+    desc_commandline.add(chapel::get_config_variables());
+
+    hpx::init_params init_args;
+    init_args.desc_cmdline = desc_commandline;
+
+    HPX_TEST_EQ(hpx::init(argc, argv, init_args), 0);
+    return hpx::util::report_errors();
+}